@@ -0,0 +1,57 @@
+/**
+ * @file bench_common.c
+ * @brief Allocation counting, timing and a headless display for the programs in bench/.
+ */
+#include "bench_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// --- Allocation Counting ---
+// The Makefile links with -Wl,--wrap for each of these, so every call from the
+// binding core, the simulator and LVGL widgets lands here first.
+
+unsigned long long bench_alloc_count = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_lv_malloc(size_t size);
+void* __real_lv_malloc_zeroed(size_t size);
+void* __real_lv_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) { bench_alloc_count++; return __real_malloc(size); }
+void* __wrap_calloc(size_t n, size_t size) { bench_alloc_count++; return __real_calloc(n, size); }
+void* __wrap_realloc(void* ptr, size_t size) { bench_alloc_count++; return __real_realloc(ptr, size); }
+void* __wrap_lv_malloc(size_t size) { bench_alloc_count++; return __real_lv_malloc(size); }
+void* __wrap_lv_malloc_zeroed(size_t size) { bench_alloc_count++; return __real_lv_malloc_zeroed(size); }
+void* __wrap_lv_realloc(void* ptr, size_t size) { bench_alloc_count++; return __real_lv_realloc(ptr, size); }
+
+// --- Headless Display ---
+
+static lv_color32_t draw_buf[BENCH_HOR_RES * 40];
+
+static void bench_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+lv_display_t* bench_display_create(void) {
+    lv_display_t* disp = lv_display_create(BENCH_HOR_RES, BENCH_VER_RES);
+    lv_display_set_buffers(disp, draw_buf, NULL, sizeof(draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, bench_flush_cb);
+    return disp;
+}
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void render_abort(const char* msg) {
+    fprintf(stderr, "\nFATAL ERROR: %s\n\n", msg);
+    fflush(stderr);
+    exit(1);
+}
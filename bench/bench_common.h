@@ -0,0 +1,31 @@
+/**
+ * @file bench_common.h
+ * @brief Allocation counting, timing and a headless display for the programs in bench/.
+ */
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "lvgl.h"
+#include <stdint.h>
+
+#define BENCH_HOR_RES 800
+#define BENCH_VER_RES 480
+
+/**
+ * @brief Heap allocations (libc and LVGL) made so far. Counted by wrapping the
+ * allocators at link time (see BENCH_WRAP in the Makefile).
+ */
+extern unsigned long long bench_alloc_count;
+
+/**
+ * @brief Returns the monotonic wall clock in nanoseconds.
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * @brief Creates a BENCH_HOR_RES x BENCH_VER_RES display that renders into a
+ * static buffer and drops the result, so LVGL draws without SDL.
+ */
+lv_display_t* bench_display_create(void);
+
+#endif // BENCH_COMMON_H
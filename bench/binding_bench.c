@@ -0,0 +1,283 @@
+/**
+ * @file binding_bench.c
+ * @brief Headless microbenchmark for the data binding core.
+ *
+ * Creates N widgets bound to M states on a dummy LVGL display (no SDL), drives
+ * data_binding_notify_state_changed() in rounds and reports, per observer type
+ * and for the action path (where a call is one button click):
+ *   - ns/call:     wall time of the calls alone, rendering excluded;
+ *   - allocs/call: heap allocations (libc and LVGL) made during those calls;
+ *   - px/call:     pixels invalidated, from the binding statistics.
+ *
+ * Build and run with `make bench`. Allocations are counted by wrapping the
+ * allocators at link time (see BENCH_WRAP in the Makefile).
+ */
+#include "bench_common.h"
+#include "data_binding.h"
+#include "utils.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_CELL_W 40
+#define BENCH_CELL_H 24
+
+typedef enum {
+    BENCH_OBSERVER, // Notifies states observed through `type`
+    BENCH_ACTION,   // Clicks buttons carrying a cycle action
+} bench_kind_t;
+
+typedef struct {
+    const char* name;
+    bench_kind_t kind;
+    observer_update_type_t type;
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    { "text",     BENCH_OBSERVER, OBSERVER_TYPE_TEXT },
+    { "style",    BENCH_OBSERVER, OBSERVER_TYPE_STYLE },
+    { "visible",  BENCH_OBSERVER, OBSERVER_TYPE_VISIBLE },
+    { "checked",  BENCH_OBSERVER, OBSERVER_TYPE_CHECKED },
+    { "disabled", BENCH_OBSERVER, OBSERVER_TYPE_DISABLED },
+    { "value",    BENCH_OBSERVER, OBSERVER_TYPE_VALUE },
+    { "action",   BENCH_ACTION,   OBSERVER_TYPE_TEXT },
+};
+
+// --- Benchmark ---
+
+static uint32_t bench_tick_cb(void) {
+    return (uint32_t)(bench_now_ns() / 1000000ull);
+}
+
+static const bool bind_direct = true;
+static const int32_t anim_off = LV_ANIM_OFF;
+static lv_style_t style_on;
+static lv_style_t style_off;
+static binding_map_entry_t style_map[2];
+
+static const binding_value_t cycle_values[] = {
+    { .type = BINDING_TYPE_INT, .as.i_val = 0 },
+    { .type = BINDING_TYPE_INT, .as.i_val = 1 },
+    { .type = BINDING_TYPE_INT, .as.i_val = 2 },
+};
+
+static uint32_t action_dispatches = 0;
+
+static void bench_action_handler(data_binding_action_id_t action_id, binding_value_t value, void* user_data) {
+    (void)action_id;
+    (void)value;
+    (void)user_data;
+    action_dispatches++;
+}
+
+static lv_obj_t* create_bench_widget(lv_obj_t* parent, const bench_case_t* bc, uint32_t index) {
+    lv_obj_t* widget;
+    if (bc->kind == BENCH_ACTION) {
+        widget = lv_button_create(parent);
+    } else {
+        switch (bc->type) {
+            case OBSERVER_TYPE_TEXT:
+                widget = lv_label_create(parent);
+                break;
+            case OBSERVER_TYPE_VALUE:
+                widget = lv_bar_create(parent);
+                lv_bar_set_range(widget, 0, 100);
+                break;
+            case OBSERVER_TYPE_CHECKED:
+            case OBSERVER_TYPE_DISABLED:
+                widget = lv_button_create(parent);
+                lv_obj_add_flag(widget, LV_OBJ_FLAG_CHECKABLE);
+                break;
+            default:
+                widget = lv_obj_create(parent);
+                break;
+        }
+    }
+
+    // Lay the widgets out on a grid; once the screen is full, later rows stack
+    // on the earlier ones so every widget stays visible and gets invalidated.
+    uint32_t cols = BENCH_HOR_RES / BENCH_CELL_W;
+    uint32_t rows = BENCH_VER_RES / BENCH_CELL_H;
+    lv_obj_set_pos(widget, (int32_t)((index % cols) * BENCH_CELL_W), (int32_t)(((index / cols) % rows) * BENCH_CELL_H));
+    lv_obj_set_size(widget, BENCH_CELL_W - 4, BENCH_CELL_H - 4);
+    return widget;
+}
+
+static void bind_bench_widget(lv_obj_t* widget, const bench_case_t* bc, const char* name) {
+    if (bc->kind == BENCH_ACTION) {
+        data_binding_add_action(widget, name, ACTION_TYPE_CYCLE, cycle_values, 3, NULL, 0, 0);
+        return;
+    }
+    switch (bc->type) {
+        case OBSERVER_TYPE_TEXT:
+            data_binding_add_observer(name, widget, OBSERVER_TYPE_TEXT, "%d", 0, NULL);
+            break;
+        case OBSERVER_TYPE_STYLE:
+            data_binding_add_observer(name, widget, OBSERVER_TYPE_STYLE, style_map, 2, NULL);
+            break;
+        case OBSERVER_TYPE_VALUE:
+            data_binding_add_observer(name, widget, OBSERVER_TYPE_VALUE, &anim_off, sizeof(anim_off), NULL);
+            break;
+        default:
+            data_binding_add_observer(name, widget, bc->type, &bind_direct, 0, NULL);
+            break;
+    }
+}
+
+// The value every state gets in `round`. It differs from the previous round's,
+// so no notification is dropped as unchanged.
+static binding_value_t bench_value(const bench_case_t* bc, uint32_t round) {
+    switch (bc->type) {
+        case OBSERVER_TYPE_STYLE:
+            return (binding_value_t){ .type = BINDING_TYPE_STRING, .as.s_val = (round & 1) ? "on" : "off" };
+        case OBSERVER_TYPE_VISIBLE:
+        case OBSERVER_TYPE_CHECKED:
+        case OBSERVER_TYPE_DISABLED:
+            return (binding_value_t){ .type = BINDING_TYPE_BOOL, .as.b_val = (round & 1) != 0 };
+        case OBSERVER_TYPE_VALUE:
+            return (binding_value_t){ .type = BINDING_TYPE_INT, .as.i_val = (int32_t)(round % 101) };
+        default:
+            return (binding_value_t){ .type = BINDING_TYPE_INT, .as.i_val = (int32_t)round };
+    }
+}
+
+// Runs one round: notifies every state once, or clicks every button once for
+// the action case. Returns the time spent in the binding calls.
+static uint64_t run_round(const bench_case_t* bc, char** names, uint32_t state_count,
+                          lv_obj_t** widgets, uint32_t widget_count, uint32_t round) {
+    uint64_t start = bench_now_ns();
+    if (bc->kind == BENCH_ACTION) {
+        for (uint32_t i = 0; i < widget_count; i++) {
+            lv_obj_send_event(widgets[i], LV_EVENT_CLICKED, NULL);
+        }
+    } else {
+        binding_value_t value = bench_value(bc, round);
+        for (uint32_t s = 0; s < state_count; s++) {
+            data_binding_notify_state_changed(names[s], value);
+        }
+    }
+    return bench_now_ns() - start;
+}
+
+static void run_case(const bench_case_t* bc, uint32_t widget_count, uint32_t state_count, uint32_t rounds) {
+    lv_obj_t* screen = lv_screen_active();
+    lv_obj_clean(screen);
+    data_binding_init();
+    data_binding_register_action_id_handler(bench_action_handler, NULL);
+
+    char** names = malloc(state_count * sizeof(char*));
+    lv_obj_t** widgets = malloc(widget_count * sizeof(lv_obj_t*));
+    if (!names || !widgets) render_abort("Failed to allocate benchmark tables.");
+    for (uint32_t s = 0; s < state_count; s++) {
+        char name[32];
+        snprintf(name, sizeof(name), "bench|%s_%u", bc->name, (unsigned)s);
+        names[s] = strdup(name);
+        if (!names[s]) render_abort("Failed to allocate benchmark state name.");
+    }
+    for (uint32_t i = 0; i < widget_count; i++) {
+        widgets[i] = create_bench_widget(screen, bc, i);
+        bind_bench_widget(widgets[i], bc, names[i % state_count]);
+    }
+    lv_refr_now(NULL);
+
+    // Warm-up round, so one-time costs (label text buffers, style caches) are
+    // not charged to the first timed round.
+    uint32_t round = 1;
+    run_round(bc, names, state_count, widgets, widget_count, round++);
+    lv_refr_now(NULL);
+
+    uint64_t elapsed = 0;
+    unsigned long long allocs = 0;
+    for (uint32_t r = 0; r < rounds; r++) {
+        unsigned long long allocs_before = bench_alloc_count;
+        elapsed += run_round(bc, names, state_count, widgets, widget_count, round++);
+        allocs += bench_alloc_count - allocs_before;
+        lv_refr_now(NULL);
+    }
+
+    // One more round with statistics on, for the invalidated area. The
+    // statistics add a display event callback, so they stay off while timing.
+    data_binding_set_stats_enabled(true);
+    data_binding_reset_stats();
+    run_round(bc, names, state_count, widgets, widget_count, round++);
+    data_binding_set_stats_enabled(false);
+    uint64_t invalidated = 0;
+    uint32_t stat_count = data_binding_get_stats(NULL, 0);
+    data_binding_state_stats_t* stats = malloc((stat_count ? stat_count : 1) * sizeof(data_binding_state_stats_t));
+    if (!stats) render_abort("Failed to allocate binding stats.");
+    data_binding_get_stats(stats, stat_count);
+    for (uint32_t i = 0; i < stat_count; i++) invalidated += stats[i].invalidated_area;
+    free(stats);
+    lv_refr_now(NULL);
+    if (bc->kind == BENCH_ACTION && action_dispatches == 0) print_warning("The action case dispatched nothing.");
+
+    // The action case dispatches once per button and invalidates nothing through
+    // the binding core (the button redraws itself), so it is reported per dispatch.
+    uint32_t calls_per_round = bc->kind == BENCH_ACTION ? widget_count : state_count;
+    unsigned long long calls = (unsigned long long)calls_per_round * rounds;
+    printf("%-10s %8u %8u %10llu %12.1f %14.2f %12.1f\n", bc->name,
+           (unsigned)widget_count, (unsigned)state_count, calls,
+           calls ? (double)elapsed / (double)calls : 0.0,
+           calls ? (double)allocs / (double)calls : 0.0,
+           calls_per_round ? (double)invalidated / (double)calls_per_round : 0.0);
+
+    lv_obj_clean(screen);
+    for (uint32_t s = 0; s < state_count; s++) free(names[s]);
+    free(names);
+    free(widgets);
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  --widgets <N>   Number of bound widgets (default 1000).\n");
+    fprintf(stderr, "  --states <M>    Number of states the widgets are spread over (default 100).\n");
+    fprintf(stderr, "  --rounds <R>    Timed rounds; each notifies every state once (default 200).\n");
+    fprintf(stderr, "  --case <name>   Run only one case: text, style, visible, checked, disabled, value or action.\n");
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t widget_count = 1000;
+    uint32_t state_count = 100;
+    uint32_t rounds = 200;
+    const char* only_case = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--widgets") == 0 && i + 1 < argc) { widget_count = (uint32_t)strtoul(argv[++i], NULL, 10); }
+        else if (strcmp(argv[i], "--states") == 0 && i + 1 < argc) { state_count = (uint32_t)strtoul(argv[++i], NULL, 10); }
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) { rounds = (uint32_t)strtoul(argv[++i], NULL, 10); }
+        else if (strcmp(argv[i], "--case") == 0 && i + 1 < argc) { only_case = argv[++i]; }
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (widget_count == 0 || state_count == 0 || state_count > widget_count) {
+        fprintf(stderr, "Error: need 0 < states <= widgets.\n");
+        return 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(bench_tick_cb);
+    bench_display_create();
+
+    lv_style_init(&style_on);
+    lv_style_set_bg_color(&style_on, lv_color_hex(0x00A000));
+    lv_style_init(&style_off);
+    lv_style_set_bg_color(&style_off, lv_color_hex(0xA00000));
+    style_map[0] = (binding_map_entry_t){ .key = { .type = BINDING_TYPE_STRING, .as.s_val = "on" }, .value.p_val = &style_on };
+    style_map[1] = (binding_map_entry_t){ .key = { .type = BINDING_TYPE_STRING, .as.s_val = "off" }, .value.p_val = &style_off };
+
+    printf("%-10s %8s %8s %10s %12s %14s %12s\n", "case", "widgets", "states", "calls", "ns/call", "allocs/call", "px/call");
+    bool matched = false;
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        if (only_case && strcmp(only_case, bench_cases[i].name) != 0) continue;
+        matched = true;
+        run_case(&bench_cases[i], widget_count, state_count, rounds);
+    }
+    if (!matched) {
+        fprintf(stderr, "Error: unknown case '%s'.\n", only_case);
+        return 1;
+    }
+    return 0;
+}
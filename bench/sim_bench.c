@@ -0,0 +1,171 @@
+/**
+ * @file sim_bench.c
+ * @brief Headless fast-forward runner for UI-Sim definitions.
+ *
+ * Loads a UI spec, runs the simulation of its `data-binding` block for a number
+ * of ticks as fast as possible and reports, for every interval and for the run:
+ *   - ticks/s:       simulated ticks per second of wall time;
+ *   - notifies/tick: state notifications the simulator sent to the binding core;
+ *   - allocs/tick:   heap allocations (libc and LVGL) made while ticking.
+ *
+ * Time is deterministic: every tick advances the simulation by the same `--dt`,
+ * and LVGL's tick follows the simulated clock instead of the wall clock. `time`
+ * is a float, so it gets coarser on long runs (see "Fast-Forward Runs" in
+ * docs/ui_sim.md). By default no widgets exist, so only the simulator and the
+ * binding core run. With --render the UI is built on a dummy display (no SDL)
+ * and LVGL runs its timers after every tick, so observers, layout and drawing
+ * are included.
+ *
+ * Build and run with `make sim-bench`. Allocations and notifications are counted
+ * by wrapping the functions at link time (see SIM_BENCH_WRAP in the Makefile).
+ */
+#include "bench_common.h"
+#include "api_spec.h"
+#include "data_binding.h"
+#include "generator.h"
+#include "ir.h"
+#include "lvgl_renderer.h"
+#include "registry.h"
+#include "ui_sim.h"
+#include "utils.h"
+#include "lvgl.h"
+#include <cJSON.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Defined by main.c in the generator.
+bool g_strict_mode = false;
+bool g_strict_registry_mode = false;
+bool g_ui_sim_trace_enabled = false;
+bool g_ui_sim_trace_no_time_enabled = false;
+
+// --- Notification Counting and Simulated Clock ---
+// Allocations are counted by bench_common.c. The Makefile also wraps
+// data_binding_notify_state_changed(), so every notification the simulator
+// sends to the binding core lands here first.
+
+static unsigned long long notify_count = 0;
+
+void __real_data_binding_notify_state_changed(const char* state_name, binding_value_t new_value);
+
+void __wrap_data_binding_notify_state_changed(const char* state_name, binding_value_t new_value) {
+    notify_count++;
+    __real_data_binding_notify_state_changed(state_name, new_value);
+}
+
+static uint64_t sim_time_us = 0;
+
+static uint32_t sim_tick_cb(void) {
+    return (uint32_t)(sim_time_us / 1000ull);
+}
+
+// --- Runner ---
+
+typedef struct {
+    unsigned long long ticks;
+    uint64_t start_ns;
+    unsigned long long notifies_start;
+    unsigned long long allocs_start;
+} run_span_t;
+
+static run_span_t span_begin(unsigned long long tick) {
+    return (run_span_t){ .ticks = tick, .start_ns = bench_now_ns(), .notifies_start = notify_count, .allocs_start = bench_alloc_count };
+}
+
+// Prints the rates of the ticks since `span` began, up to and including `tick`.
+static void print_row(const char* label, const run_span_t* span, unsigned long long tick) {
+    uint64_t elapsed = bench_now_ns() - span->start_ns;
+    double ticks = (double)(tick - span->ticks);
+    printf("%-10s %14llu %14.0f %14.2f %14.3f\n", label, tick,
+           elapsed ? ticks * 1e9 / (double)elapsed : 0.0,
+           ticks > 0 ? (double)(notify_count - span->notifies_start) / ticks : 0.0,
+           ticks > 0 ? (double)(bench_alloc_count - span->allocs_start) / ticks : 0.0);
+    fflush(stdout);
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options] <api_spec.json> <ui_spec.yaml|json>\n", prog);
+    fprintf(stderr, "  --ticks <N>     Ticks to simulate (default 1000000).\n");
+    fprintf(stderr, "  --dt <seconds>  Simulated time per tick (default 0.033, as --run-sim-test).\n");
+    fprintf(stderr, "  --report <N>    Print a row every N ticks (default 1000000, 0 for the total only).\n");
+    fprintf(stderr, "  --render        Build the UI on a dummy display and run LVGL after every tick.\n");
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long long tick_limit = 1000000;
+    unsigned long long report_every = 1000000;
+    float dt = 0.033f;
+    bool render = false;
+    const char* api_spec_path = NULL;
+    const char* ui_spec_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) { tick_limit = strtoull(argv[++i], NULL, 10); }
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) { dt = strtof(argv[++i], NULL); }
+        else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) { report_every = strtoull(argv[++i], NULL, 10); }
+        else if (strcmp(argv[i], "--render") == 0) { render = true; }
+        else if (argv[i][0] != '-' && !api_spec_path) { api_spec_path = argv[i]; }
+        else if (argv[i][0] != '-' && !ui_spec_path) { ui_spec_path = argv[i]; }
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!api_spec_path || !ui_spec_path || !(dt > 0.0f)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(sim_tick_cb);
+    if (render) bench_display_create();
+    data_binding_init();
+
+    char* api_spec_content = read_file(api_spec_path);
+    if (!api_spec_content) { fprintf(stderr, "Error reading API spec file: %s\n", api_spec_path); return 1; }
+    cJSON* api_spec_json = cJSON_Parse(api_spec_content);
+    if (!api_spec_json) { fprintf(stderr, "Error parsing API spec JSON: %s\n", cJSON_GetErrorPtr()); return 1; }
+    ApiSpec* api_spec = api_spec_parse(api_spec_json);
+    if (!api_spec) { fprintf(stderr, "Failed to parse API spec.\n"); return 1; }
+
+    // Also configures the simulator from the spec's `data-binding` block.
+    IRRoot* ir_root = generate_ir_from_file(ui_spec_path, api_spec);
+    if (!ir_root) { fprintf(stderr, "Aborting due to IR generation failure.\n"); return 1; }
+
+    Registry* registry = NULL;
+    if (render) {
+        registry = registry_create();
+        lvgl_render_backend(ir_root, api_spec, lv_screen_active(), registry);
+        lv_refr_now(NULL);
+    }
+    ui_sim_start();
+    if (notify_count == 0) {
+        print_warning("The simulator sent no notifications on start; '%s' may have no data-binding block.", ui_spec_path);
+    }
+
+    printf("%-10s %14s %14s %14s %14s\n", "", "ticks", "ticks/s", "notifies/tick", "allocs/tick");
+    run_span_t total = span_begin(0);
+    run_span_t interval = total;
+    for (unsigned long long tick = 1; tick <= tick_limit; tick++) {
+        // Same clock as UI-Sim's `time`, derived from the tick count so it never drifts.
+        sim_time_us = (uint64_t)llround((double)tick * (double)dt * 1e6);
+        ui_sim_tick(dt);
+        if (render) lv_timer_handler();
+
+        if (report_every && tick % report_every == 0 && tick < tick_limit) {
+            print_row("interval", &interval, tick);
+            interval = span_begin(tick);
+        }
+    }
+    print_row("total", &total, tick_limit);
+
+    ui_sim_init();
+    if (registry) registry_free(registry);
+    ir_free((IRNode*)ir_root);
+    api_spec_free(api_spec);
+    cJSON_Delete(api_spec_json);
+    free(api_spec_content);
+    return 0;
+}
@@ -22,11 +22,27 @@ typedef struct MapNode {
     struct MapNode* next;
 } MapNode;
 
+// --- Observed State / Action Name List (in order of first use) ---
+typedef struct StateNameNode {
+    char* name;    // State or action name as written in the UI spec
+    char* c_ident; // Generated UI_STATE_* or UI_ACTION_* enum constant
+    struct StateNameNode* next;
+} StateNameNode;
+
+
+// --- Observers Registered Through the ui_observers Table ---
+typedef struct TableObserverNode {
+    IRObserver* obs;
+    const char* widget_c_name;
+    int widget_index; // Index into ui_observer_widgets
+    struct TableObserverNode* next;
+} TableObserverNode;
+
 
 // --- Forward Declarations ---
 static void print_expr(IRExpr* expr, const char* parent_c_name, IdMapNode* id_map, MapNode* array_map, bool pass_by_ref_for_struct);
-static void print_object_list(IRObject* head, int indent_level, const char* parent_c_name, IdMapNode* id_map, MapNode* array_map);
-static void print_node(IRNode* node, int indent_level, const char* parent_c_name, const char* target_c_name, IdMapNode* id_map, MapNode* array_map);
+static void print_object_list(IRObject* head, int indent_level, const char* parent_c_name, IdMapNode* id_map, MapNode* array_map, MapNode* table_map);
+static void print_node(IRNode* node, int indent_level, const char* parent_c_name, const char* target_c_name, IdMapNode* id_map, MapNode* array_map, MapNode* table_map);
 static void find_and_map_arrays(IRObject* head, MapNode** array_map_head, int* counter);
 static void id_map_dump(IdMapNode* map_head);
 
@@ -106,6 +122,150 @@ static void generic_map_free(MapNode* map_head) {
 }
 
 
+// --- Map Helpers: State Name List ---
+static bool state_list_contains(StateNameNode* head, const char* name, bool match_ident) {
+    for (StateNameNode* current = head; current; current = current->next) {
+        if (strcmp(match_ident ? current->c_ident : current->name, name) == 0) return true;
+    }
+    return false;
+}
+
+// Turns "position|x" into "UI_STATE_POSITION_X" (with prefix "UI_STATE_").
+// Names that collapse to the same identifier get a numeric suffix.
+static char* make_state_ident(StateNameNode* head, const char* prefix, const char* name) {
+    size_t len = strlen(name);
+    char* ident = malloc(strlen(prefix) + len + 32);
+    if (!ident) render_abort("Failed to allocate state identifier");
+    strcpy(ident, prefix);
+    char* out = ident + strlen(ident);
+    for (const char* p = name; *p; p++) {
+        *out++ = isalnum((unsigned char)*p) ? (char)toupper((unsigned char)*p) : '_';
+    }
+    *out = '\0';
+
+    size_t base_len = strlen(ident);
+    for (int suffix = 2; state_list_contains(head, ident, true); suffix++) {
+        snprintf(ident + base_len, 32, "_%d", suffix);
+    }
+    return ident;
+}
+
+static void state_list_append(StateNameNode** head, const char* prefix, const char* name) {
+    if (!name || state_list_contains(*head, name, false)) return;
+    StateNameNode* new_node = malloc(sizeof(StateNameNode));
+    if (!new_node) render_abort("Failed to allocate StateNameNode");
+    new_node->name = strdup(name);
+    new_node->c_ident = make_state_ident(*head, prefix, name);
+    new_node->next = NULL;
+    StateNameNode** tail = head;
+    while (*tail) tail = &(*tail)->next;
+    *tail = new_node;
+}
+
+static void state_list_free(StateNameNode* head) {
+    while (head) {
+        StateNameNode* next = head->next;
+        free(head->name);
+        free(head->c_ident);
+        free(head);
+        head = next;
+    }
+}
+
+static void collect_state_names(IRObject* head, StateNameNode** list) {
+    for (IRObject* current = head; current; current = current->next) {
+        for (IROperationNode* op = current->operations; op; op = op->next) {
+            if (op->op_node->type == IR_NODE_OBJECT) {
+                collect_state_names((IRObject*)op->op_node, list);
+            } else if (op->op_node->type == IR_NODE_OBSERVER) {
+                state_list_append(list, "UI_STATE_", ((IRObserver*)op->op_node)->state_name);
+            }
+        }
+    }
+}
+
+static void collect_action_names(IRObject* head, StateNameNode** list) {
+    for (IRObject* current = head; current; current = current->next) {
+        for (IROperationNode* op = current->operations; op; op = op->next) {
+            if (op->op_node->type == IR_NODE_OBJECT) {
+                collect_action_names((IRObject*)op->op_node, list);
+            } else if (op->op_node->type == IR_NODE_ACTION) {
+                state_list_append(list, "UI_ACTION_", ((IRAction*)op->op_node)->action_name);
+            }
+        }
+    }
+}
+
+// Derived states and their inputs are registered like observed states, so
+// that the application can notify the inputs through their UI_STATE_* handles.
+static void collect_derived_state_names(IRDerivedState* head, StateNameNode** list) {
+    for (IRDerivedState* ds = head; ds; ds = ds->next) {
+        for (uint32_t i = 0; i < ds->input_count; i++) {
+            state_list_append(list, "UI_STATE_", ds->inputs[i]);
+        }
+        state_list_append(list, "UI_STATE_", ds->state_name);
+    }
+}
+
+static int state_list_index(StateNameNode* head, const char* name) {
+    int index = 0;
+    for (StateNameNode* current = head; current; current = current->next, index++) {
+        if (strcmp(current->name, name) == 0) return index;
+    }
+    return -1;
+}
+
+
+// --- Observer Table ---
+
+// Collects the observers whose config is a compile-time constant, so they can
+// be emitted as one static const table. STYLE observers point at styles that
+// create_ui() allocates at runtime and keep their own data_binding_add_observer()
+// call. `table_map` maps each collected observer to "ui_observers", and each
+// widget with such observers to its slot in ui_observer_widgets.
+static void collect_table_observers(IRObject* head, TableObserverNode** list, MapNode** table_map, int* widget_count) {
+    for (IRObject* current = head; current; current = current->next) {
+        if (strncmp(current->json_type, "//", 2) == 0) continue;
+        int widget_index = -1;
+        for (IROperationNode* op = current->operations; op; op = op->next) {
+            if (op->op_node->type == IR_NODE_OBJECT) {
+                collect_table_observers((IRObject*)op->op_node, list, table_map, widget_count);
+                continue;
+            }
+            if (op->op_node->type != IR_NODE_OBSERVER) continue;
+            IRObserver* obs = (IRObserver*)op->op_node;
+            if (obs->update_type == OBSERVER_TYPE_STYLE) continue;
+
+            if (widget_index < 0) {
+                char slot[64];
+                widget_index = (*widget_count)++;
+                snprintf(slot, sizeof(slot), "ui_observer_widgets[%d]", widget_index);
+                generic_map_add(table_map, current, slot);
+            }
+            generic_map_add(table_map, obs, "ui_observers");
+
+            TableObserverNode* new_node = malloc(sizeof(TableObserverNode));
+            if (!new_node) render_abort("Failed to allocate TableObserverNode");
+            new_node->obs = obs;
+            new_node->widget_c_name = current->c_name;
+            new_node->widget_index = widget_index;
+            new_node->next = NULL;
+            TableObserverNode** tail = list;
+            while (*tail) tail = &(*tail)->next;
+            *tail = new_node;
+        }
+    }
+}
+
+static void table_observer_list_free(TableObserverNode* head) {
+    while (head) {
+        TableObserverNode* next = head->next;
+        free(head);
+        head = next;
+    }
+}
+
+
 // --- Printing Helpers ---
 
 static void print_indent(int level) {
@@ -261,11 +421,80 @@ static void print_expr(IRExpr* expr, const char* parent_c_name, IdMapNode* id_ma
     }
 }
 
-static void print_node(IRNode* node, int indent_level, const char* parent_c_name, const char* target_c_name, IdMapNode* id_map, MapNode* array_map) {
+// Prints the config, config_len and default_value arguments of an observer.
+static void print_observer_config(IRObserver* obs, const char* parent_c_name, IdMapNode* id_map, MapNode* array_map) {
+    if (obs->config_expr->base.type == IR_EXPR_LITERAL) {
+        IRExprLiteral* lit = (IRExprLiteral*)obs->config_expr;
+        if (lit->is_string) {
+            print_c_string_literal(lit->value, lit->len);
+            printf(", 0, NULL");
+        } else {
+            printf("&(const bool){%s}, 0, NULL", lit->value);
+        }
+    } else if (obs->config_expr->base.type == IR_EXPR_ARRAY) { // Map
+        IRExprArray* arr = (IRExprArray*)obs->config_expr;
+        IRExpr* default_val_expr = NULL;
+        for (IRExprNode* n = arr->elements; n; n = n->next) {
+            IRExprArray* pair = (IRExprArray*)n->expr;
+            IRExprLiteral* key_lit = (IRExprLiteral*)pair->elements->expr;
+            if (key_lit->is_string && strcmp(key_lit->value, "default") == 0) {
+                default_val_expr = pair->elements->next->expr;
+                break;
+            }
+        }
+        
+        printf("(const binding_map_entry_t[]){ ");
+        int count = 0;
+        bool first = true;
+        for (IRExprNode* n = arr->elements; n; n = n->next) {
+            IRExprArray* pair = (IRExprArray*)n->expr;
+            IRExpr* key_expr = pair->elements->expr;
+            if (key_expr->base.type == IR_EXPR_LITERAL && ((IRExprLiteral*)key_expr)->is_string && strcmp(((IRExprLiteral*)key_expr)->value, "default") == 0) {
+                continue;
+            }
+            if (!first) printf(", ");
+            printf("{ .key = ");
+            print_binding_value(key_expr, parent_c_name, id_map, array_map);
+            printf(", .value = { ");
+            if (obs->update_type == OBSERVER_TYPE_STYLE) {
+                printf(".p_val = (void*)");
+                print_expr(pair->elements->next->expr, parent_c_name, id_map, array_map, true);
+            } else {
+                printf(".b_val = ");
+                print_expr(pair->elements->next->expr, parent_c_name, id_map, array_map, false);
+            }
+            printf(" } }");
+            first = false;
+            count++;
+        }
+        printf(" }, %d, ", count);
+        
+        if (default_val_expr) {
+            if (obs->update_type == OBSERVER_TYPE_STYLE) {
+                if(default_val_expr->base.type == IR_EXPR_LITERAL && strcmp(((IRExprLiteral*)default_val_expr)->value, "NULL") == 0) {
+                    printf("NULL");
+                } else {
+                    printf("(const void*)");
+                    print_expr(default_val_expr, parent_c_name, id_map, array_map, true);
+                }
+            } else {
+                printf("(const void*)&(const bool){");
+                print_expr(default_val_expr, parent_c_name, id_map, array_map, false);
+                printf("}");
+            }
+        } else {
+            printf("NULL");
+        }
+    } else {
+         printf("NULL, 0, NULL");
+    }
+}
+
+static void print_node(IRNode* node, int indent_level, const char* parent_c_name, const char* target_c_name, IdMapNode* id_map, MapNode* array_map, MapNode* table_map) {
     if (!node) return;
     switch(node->type) {
         case IR_NODE_OBJECT:
-            print_object_list((IRObject*)node, indent_level, target_c_name, id_map, array_map);
+            print_object_list((IRObject*)node, indent_level, target_c_name, id_map, array_map, table_map);
             break;
         case IR_NODE_WARNING:
             print_indent(indent_level);
@@ -273,74 +502,11 @@ static void print_node(IRNode* node, int indent_level, const char* parent_c_name
             break;
         case IR_NODE_OBSERVER: {
             IRObserver* obs = (IRObserver*)node;
+            // Observers in the ui_observers table are registered at the end of create_ui().
+            if (generic_map_get_name(table_map, obs)) break;
             print_indent(indent_level);
             printf("data_binding_add_observer(\"%s\", %s, %d, ", obs->state_name, target_c_name, obs->update_type);
-
-            if (obs->config_expr->base.type == IR_EXPR_LITERAL) {
-                IRExprLiteral* lit = (IRExprLiteral*)obs->config_expr;
-                if (lit->is_string) {
-                    print_c_string_literal(lit->value, lit->len);
-                    printf(", 0, NULL");
-                } else {
-                    printf("&(bool){%s}, 0, NULL", lit->value);
-                }
-            } else if (obs->config_expr->base.type == IR_EXPR_ARRAY) { // Map
-                IRExprArray* arr = (IRExprArray*)obs->config_expr;
-                IRExpr* default_val_expr = NULL;
-                for (IRExprNode* n = arr->elements; n; n = n->next) {
-                    IRExprArray* pair = (IRExprArray*)n->expr;
-                    IRExprLiteral* key_lit = (IRExprLiteral*)pair->elements->expr;
-                    if (key_lit->is_string && strcmp(key_lit->value, "default") == 0) {
-                        default_val_expr = pair->elements->next->expr;
-                        break;
-                    }
-                }
-                
-                printf("(const binding_map_entry_t[]){ ");
-                int count = 0;
-                bool first = true;
-                for (IRExprNode* n = arr->elements; n; n = n->next) {
-                    IRExprArray* pair = (IRExprArray*)n->expr;
-                    IRExpr* key_expr = pair->elements->expr;
-                    if (key_expr->base.type == IR_EXPR_LITERAL && ((IRExprLiteral*)key_expr)->is_string && strcmp(((IRExprLiteral*)key_expr)->value, "default") == 0) {
-                        continue;
-                    }
-                    if (!first) printf(", ");
-                    printf("{ .key = ");
-                    print_binding_value(key_expr, parent_c_name, id_map, array_map);
-                    printf(", .value = { ");
-                    if (obs->update_type == OBSERVER_TYPE_STYLE) {
-                        printf(".p_val = (void*)");
-                        print_expr(pair->elements->next->expr, parent_c_name, id_map, array_map, true);
-                    } else {
-                        printf(".b_val = ");
-                        print_expr(pair->elements->next->expr, parent_c_name, id_map, array_map, false);
-                    }
-                    printf(" } }");
-                    first = false;
-                    count++;
-                }
-                printf(" }, %d, ", count);
-                
-                if (default_val_expr) {
-                    if (obs->update_type == OBSERVER_TYPE_STYLE) {
-                        if(default_val_expr->base.type == IR_EXPR_LITERAL && strcmp(((IRExprLiteral*)default_val_expr)->value, "NULL") == 0) {
-                            printf("NULL");
-                        } else {
-                            printf("(const void*)");
-                            print_expr(default_val_expr, parent_c_name, id_map, array_map, true);
-                        }
-                    } else {
-                        printf("(const void*)&(bool){");
-                        print_expr(default_val_expr, parent_c_name, id_map, array_map, false);
-                        printf("}");
-                    }
-                } else {
-                    printf("NULL");
-                }
-            } else {
-                 printf("NULL, 0, NULL");
-            }
+            print_observer_config(obs, parent_c_name, id_map, array_map);
             printf(");\n");
             break;
         }
@@ -348,17 +514,17 @@ static void print_node(IRNode* node, int indent_level, const char* parent_c_name
             IRAction* act = (IRAction*)node;
             print_indent(indent_level);
             printf("data_binding_add_action(%s, \"%s\", %d, ", target_c_name, act->action_name, act->action_type);
-            if (act->data_expr) {
+            // Only cycle values are emitted; numeric dialog configs are not
+            // supported by this backend and are passed as NULL.
+            if (act->data_expr && act->data_expr->base.type == IR_EXPR_ARRAY && act->action_type == ACTION_TYPE_CYCLE) {
                 print_expr(act->data_expr, parent_c_name, id_map, array_map, false);
-                if (act->data_expr->base.type == IR_EXPR_ARRAY) {
-                    int count = 0;
-                    for (IRExprNode* n = ((IRExprArray*)act->data_expr)->elements; n; n = n->next) count++;
-                    printf(", %d", count);
-                }
+                int count = 0;
+                for (IRExprNode* n = ((IRExprArray*)act->data_expr)->elements; n; n = n->next) count++;
+                printf(", %d", count);
             } else {
                 printf("NULL, 0");
             }
-            printf(");\n");
+            printf(", NULL, %u, %u);\n", (unsigned)act->throttle_ms, (unsigned)act->debounce_ms);
             break;
         }
         default:
@@ -429,7 +595,7 @@ static void find_and_map_arrays(IRObject* head, MapNode** array_map, int* counte
 }
 
 
-static void print_object_list(IRObject* head, int indent_level, const char* parent_c_name, IdMapNode* id_map, MapNode* array_map) {
+static void print_object_list(IRObject* head, int indent_level, const char* parent_c_name, IdMapNode* id_map, MapNode* array_map, MapNode* table_map) {
     for (IRObject* current = head; current; current = current->next) {
         if(strncmp(current->json_type, "//", 2) == 0) continue;
 
@@ -472,10 +638,16 @@ static void print_object_list(IRObject* head, int indent_level, const char* pare
             }
         }
 
+        const char* widget_slot = generic_map_get_name(table_map, current);
+        if (widget_slot) {
+            print_indent(content_indent);
+            printf("%s = %s;\n", widget_slot, current->c_name);
+        }
+
         if (current->operations) {
             printf("\n");
             for (IROperationNode* op_node = current->operations; op_node; op_node = op_node->next) {
-                print_node(op_node->op_node, content_indent, parent_c_name, current->c_name, id_map, array_map);
+                print_node(op_node->op_node, content_indent, parent_c_name, current->c_name, id_map, array_map, table_map);
             }
         }
 
@@ -488,6 +660,113 @@ static void print_object_list(IRObject* head, int indent_level, const char* pare
     }
 }
 
+// --- Derived State Tables ---
+
+static const char* const binding_op_names[] = {
+    "BINDING_OP_CONST", "BINDING_OP_INPUT", "BINDING_OP_ADD", "BINDING_OP_SUB", "BINDING_OP_MUL",
+    "BINDING_OP_DIV", "BINDING_OP_CLAMP", "BINDING_OP_SIN", "BINDING_OP_COS", "BINDING_OP_EQ",
+    "BINDING_OP_NE", "BINDING_OP_GT", "BINDING_OP_LT", "BINDING_OP_GE", "BINDING_OP_LE",
+    "BINDING_OP_AND", "BINDING_OP_OR", "BINDING_OP_NOT", "BINDING_OP_CASE",
+};
+
+// Prints a derived state constant as a binding_value_t initializer. Doubles use
+// the shortest form that reads back to the same value, whole ones as "120.0".
+static void print_derived_const(const binding_value_t* value) {
+    printf("{ ");
+    switch (value->type) {
+        case BINDING_TYPE_STRING:
+            printf(".type=BINDING_TYPE_STRING, .as.s_val=");
+            print_c_string_literal(value->as.s_val, strlen(value->as.s_val));
+            break;
+        case BINDING_TYPE_BOOL:
+            printf(".type=BINDING_TYPE_BOOL, .as.b_val=%s", value->as.b_val ? "true" : "false");
+            break;
+        default: {
+            char buf[32];
+            double d = value->as.d_val;
+            if (d == (double)(long long)d && d > -1e15 && d < 1e15) {
+                snprintf(buf, sizeof(buf), "%.1f", d);
+            } else {
+                for (int precision = 1; precision <= 17; precision++) {
+                    snprintf(buf, sizeof(buf), "%.*g", precision, d);
+                    if (strtod(buf, NULL) == d) break;
+                }
+            }
+            printf(".type=BINDING_TYPE_DOUBLE, .as.d_val=%s", buf);
+            break;
+        }
+    }
+    printf(" }");
+}
+
+// Prints the code, constant and input tables of each derived state, named
+// ui_derived_<n>_*. Input handles are indices into ui_state_names.
+static void print_derived_tables(IRDerivedState* head, StateNameNode* states) {
+    if (!head) return;
+    printf("// --- Derived states, computed by the binding runtime (added at the end of create_ui()) ---\n");
+    int index = 0;
+    for (IRDerivedState* ds = head; ds; ds = ds->next, index++) {
+        printf("// ");
+        print_c_string_literal(ds->state_name, strlen(ds->state_name));
+        printf("\n");
+        printf("static const binding_expr_instr_t ui_derived_%d_code[] = {\n", index);
+        for (uint32_t i = 0; i < ds->code_len; i++) {
+            print_indent(1);
+            printf("{ %s, %u },\n", binding_op_names[ds->code[i].op], (unsigned)ds->code[i].arg);
+        }
+        printf("};\n");
+        if (ds->const_count > 0) {
+            printf("static const binding_value_t ui_derived_%d_consts[] = {\n", index);
+            for (uint32_t i = 0; i < ds->const_count; i++) {
+                print_indent(1);
+                print_derived_const(&ds->consts[i]);
+                printf(",\n");
+            }
+            printf("};\n");
+        }
+        if (ds->input_count > 0) {
+            printf("static const data_binding_state_handle_t ui_derived_%d_inputs[] = {\n", index);
+            for (uint32_t i = 0; i < ds->input_count; i++) {
+                print_indent(1);
+                printf("%d, // %s\n", state_list_index(states, ds->inputs[i]), ds->inputs[i]);
+            }
+            printf("};\n");
+        }
+        printf("\n");
+    }
+}
+
+static void print_derived_registrations(IRDerivedState* head) {
+    int index = 0;
+    for (IRDerivedState* ds = head; ds; ds = ds->next, index++) {
+        print_indent(1);
+        printf("data_binding_add_derived_state(");
+        print_c_string_literal(ds->state_name, strlen(ds->state_name));
+        printf(", ui_derived_%d_code, %u, ", index, (unsigned)ds->code_len);
+        if (ds->const_count > 0) printf("ui_derived_%d_consts, %u, ", index, (unsigned)ds->const_count);
+        else printf("NULL, 0, ");
+        if (ds->input_count > 0) printf("ui_derived_%d_inputs, %u);\n", index, (unsigned)ds->input_count);
+        else printf("NULL, 0);\n");
+    }
+}
+
+// Prints a static table of the list's names, one per line with its enum
+// identifier as a comment. Returns the number of names.
+static int print_name_table(StateNameNode* list, const char* table_name, const char* description) {
+    if (!list) return 0;
+    int count = 0;
+    printf("// --- %s in create_ui.h ---\n", description);
+    printf("static const char* const %s[] = {\n", table_name);
+    for (StateNameNode* current = list; current; current = current->next) {
+        print_indent(1);
+        print_c_string_literal(current->name, strlen(current->name));
+        printf(", // %s\n", current->c_ident);
+        count++;
+    }
+    printf("};\n\n");
+    return count;
+}
+
 void c_code_print_backend(IRRoot* root, const ApiSpec* api_spec) {
     (void)api_spec;
     if (!root) { printf("/* IR Root is NULL. */\n"); return; }
@@ -504,9 +783,55 @@ void c_code_print_backend(IRRoot* root, const ApiSpec* api_spec) {
     printf("#include \"lvgl.h\"\n");
     printf("#include \"c_gen/lvgl_dispatch.h\" // For obj_registry_add\n");
     printf("#include \"data_binding.h\"\n\n");
-    
+
+    StateNameNode* states = NULL;
+    collect_state_names(root->root_objects, &states);
+    collect_derived_state_names(root->derived_states, &states);
+    int state_count = print_name_table(states, "ui_state_names", "Data binding states, indexed by the UI_STATE_* handles");
+
+    StateNameNode* actions = NULL;
+    collect_action_names(root->root_objects, &actions);
+    int action_count = print_name_table(actions, "ui_action_names", "Actions, indexed by the UI_ACTION_* IDs");
+
+    TableObserverNode* table = NULL;
+    MapNode* table_map = NULL;
+    int table_widget_count = 0;
+    int table_count = 0;
+    collect_table_observers(root->root_objects, &table, &table_map, &table_widget_count);
+    if (table) {
+        printf("// --- Observers, added in one pass at the end of create_ui() ---\n");
+        printf("// { state handle, ui_observer_widgets index, update type, config, config_len, default, flags }\n");
+        printf("// The configs are static and used in place (BINDING_OBSERVER_BORROWED).\n");
+        printf("static const binding_observer_desc_t ui_observers[] = {\n");
+        for (TableObserverNode* current = table; current; current = current->next) {
+            print_indent(1);
+            printf("{ %d, %d, %d, ", state_list_index(states, current->obs->state_name), current->widget_index, current->obs->update_type);
+            print_observer_config(current->obs, "parent", id_map, array_map);
+            printf(", BINDING_OBSERVER_BORROWED }, // %s -> %s\n", current->obs->state_name, current->widget_c_name);
+            table_count++;
+        }
+        printf("};\n\n");
+    }
+
+    print_derived_tables(root->derived_states, states);
+
     printf("void create_ui(lv_obj_t* parent) {\n");
 
+    if (table) {
+        print_indent(1);
+        printf("lv_obj_t* ui_observer_widgets[%d] = { NULL };\n", table_widget_count);
+    }
+
+    if (states) {
+        print_indent(1);
+        printf("data_binding_register_states(ui_state_names, %d);\n", state_count);
+    }
+    if (actions) {
+        print_indent(1);
+        printf("data_binding_register_actions(ui_action_names, %d);\n", action_count);
+    }
+    if (states || actions) printf("\n");
+
     if (array_map) {
         print_indent(1);
         printf("// --- Static Arrays for LVGL properties ---\n");
@@ -523,14 +848,75 @@ void c_code_print_backend(IRRoot* root, const ApiSpec* api_spec) {
     }
 
     if (root->root_objects) {
-        print_object_list(root->root_objects, 1, "parent", id_map, array_map);
+        print_object_list(root->root_objects, 1, "parent", id_map, array_map, table_map);
     } else {
         print_indent(1);
         printf("/* (No root objects) */\n");
     }
 
+    if (table) {
+        print_indent(1);
+        printf("data_binding_register_table(ui_observers, %d, ui_observer_widgets);\n", table_count);
+    }
+    // After the observers, so that the initial values reach the widgets
+    print_derived_registrations(root->derived_states);
+
     printf("}\n");
 
     id_map_free(id_map);
     generic_map_free(array_map);
+    state_list_free(states);
+    state_list_free(actions);
+    table_observer_list_free(table);
+    generic_map_free(table_map);
+}
+
+// Prints an enum of the list's identifiers, terminated by `count_ident`.
+static void print_name_enum(StateNameNode* list, const char* count_ident) {
+    printf("enum {\n");
+    for (StateNameNode* current = list; current; current = current->next) {
+        print_indent(1);
+        printf("%s, // ", current->c_ident);
+        print_c_string_literal(current->name, strlen(current->name));
+        printf("\n");
+    }
+    print_indent(1);
+    printf("%s\n", count_ident);
+    printf("};\n\n");
+}
+
+void c_header_print_backend(IRRoot* root, const ApiSpec* api_spec) {
+    (void)api_spec;
+
+    StateNameNode* states = NULL;
+    StateNameNode* actions = NULL;
+    if (root) {
+        collect_state_names(root->root_objects, &states);
+        collect_derived_state_names(root->derived_states, &states);
+        collect_action_names(root->root_objects, &actions);
+    }
+
+    printf("/* AUTO-GENERATED by the 'c_header' backend */\n\n");
+    printf("#ifndef CREATE_UI_H\n");
+    printf("#define CREATE_UI_H\n\n");
+    printf("#include \"lvgl.h\"\n");
+    printf("#include \"data_binding.h\"\n\n");
+
+    if (states) {
+        printf("// Data binding state handles. create_ui() registers the states in this\n");
+        printf("// order, so these can be passed to data_binding_notify_state_changed_h().\n");
+        print_name_enum(states, "UI_STATE_COUNT");
+    }
+
+    if (actions) {
+        printf("// Action IDs. create_ui() registers the actions in this order, so these are\n");
+        printf("// the IDs passed to a data_binding_register_action_id_handler() handler.\n");
+        print_name_enum(actions, "UI_ACTION_COUNT");
+    }
+
+    printf("void create_ui(lv_obj_t* parent);\n\n");
+    printf("#endif // CREATE_UI_H\n");
+
+    state_list_free(states);
+    state_list_free(actions);
 }
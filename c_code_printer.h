@@ -15,4 +15,15 @@
  */
 void c_code_print_backend(IRRoot* root, const ApiSpec* api_spec);
 
+/**
+ * @brief Prints the header matching the output of c_code_print_backend().
+ *
+ * Declares create_ui() and, when the UI observes any states, an enum of
+ * UI_STATE_* handles that create_ui() registers with the data binding library.
+ *
+ * @param root The root of the IR tree to print.
+ * @param api_spec The API specification, used for context if needed.
+ */
+void c_header_print_backend(IRRoot* root, const ApiSpec* api_spec);
+
 #endif // C_CODE_PRINTER_H
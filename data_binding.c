@@ -6,9 +6,21 @@
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
+#include <stddef.h>
+#include <stdatomic.h>
 
-#define MAX_STATES 128
-#define MAX_OBSERVERS_PER_STATE 32
+// Initial capacities of the growable tables below. They double as needed, so
+// memory use follows the size of the UI instead of a worst-case constant.
+#define INITIAL_STATE_CAPACITY 16
+#define INITIAL_OBSERVER_CAPACITY 32
+
+// Size of a binding arena block. Requests larger than a quarter of a block get
+// a block of their own, so they do not waste the rest of the current one.
+#define BINDING_ARENA_BLOCK_SIZE 4096
+
+// Derived state comparisons treat floats closer than this as equal, as UI-Sim
+// does, so that the generated code takes the same branches as the preview.
+#define DERIVED_FLOAT_EPSILON 1e-6
 
 // --- Runtime Observer Structures ---
 
@@ -17,22 +29,277 @@ typedef struct {
     void* config;
     size_t config_len;
     void* default_value;
-    lv_style_t* last_applied_style;
 } ObserverConfig;
 
+// A VALUE observer's configuration, with the widget setter resolved once when
+// the observer is added.
+typedef struct {
+    data_binding_value_setter_t setter; // NULL if the widget class has none
+    lv_anim_enable_t anim;
+} ValueObserverConfig;
+
+// A map observer's entries, indexed once when the observer is added. Each key
+// type gets its own lookup: a direct slot per bool, a sorted array for
+// strings, and a dense table for small integral numbers. Other numeric keys
+// are scanned. On duplicate keys the first entry wins, as in the map order.
+typedef struct {
+    const char* key;
+    uint32_t entry;
+} StringKeySlot;
+
+typedef struct {
+    const binding_map_entry_t* entries; // Arena copy with copied string keys, or the caller's borrowed table
+    uint32_t entry_count;
+    int32_t bool_entry[2];        // Entry for false/true, -1 if none
+    StringKeySlot* string_keys;   // Sorted by key
+    uint32_t string_key_count;
+    int32_t* dense_entry;         // Entry for key dense_min + i, -1 if none
+    int32_t dense_min;
+    uint32_t dense_len;
+    uint32_t* sparse_numeric_entry; // Numeric keys that did not fit the dense table
+    uint32_t sparse_numeric_count;
+} ObserverMap;
+
+// A TEXT observer's format string, parsed once when the observer is added.
+// Formats with a single %d/%i, %f or %s conversion are rendered by hand;
+// anything else falls back to snprintf with the original format.
+typedef enum {
+    TEXT_FORMAT_LITERAL, // No conversion at all
+    TEXT_FORMAT_STRING,  // %s
+    TEXT_FORMAT_INT,     // %d, %i
+    TEXT_FORMAT_FIXED,   // %f, %F with precision <= 9
+    TEXT_FORMAT_GENERIC, // Everything else, through snprintf
+} TextFormatKind;
+
+typedef struct {
+    TextFormatKind kind;
+    const char* format; // Original format, for the snprintf fallback
+    const char* prefix; // Literal text before the conversion, with %% unescaped
+    const char* suffix; // Literal text after the conversion, with %% unescaped
+    size_t prefix_len;
+    size_t suffix_len;
+    char conversion;   // Conversion character, 0 for LITERAL
+    int8_t precision;  // -1 if not given
+    uint8_t width;
+    bool left_align;   // '-'
+    bool plus_sign;    // '+'
+    bool space_sign;   // ' '
+    bool zero_pad;     // '0'
+} TextFormatter;
+
+// Observers of one state whose configs are identical, e.g. a row of buttons
+// sharing a style map. The config is stored and evaluated once per
+// notification, and the result is applied to every member widget.
 typedef struct {
-    lv_obj_t* widget;
     ObserverConfig config;
-} Observer;
+    int32_t next_group;    // Next group of the same state, -1 at the end
+    int32_t first_member;  // Index into the observer pool
+    int32_t last_member;
+    uint32_t live_members; // Members currently linked, i.e. whose widget is alive
+} ObserverGroup;
 
 typedef struct {
     char* state_name;
-    uint32_t observer_count;
-    Observer observers[MAX_OBSERVERS_PER_STATE];
-} StateObserverMapping;
+    uint32_t name_hash;
+    int32_t first_group; // Index into `observer_groups`, -1 if none
+    int32_t last_group;
+    // Deferred notification (batch or frame-flush mode)
+    bool is_pending;
+    int32_t next_pending;         // Next state in the pending list, -1 at the end
+    binding_value_t pending_value;
+    char* pending_string;         // Owned copy of a pending string value
+    size_t pending_string_cap;
+    // Last value applied to the observers, used to drop unchanged notifications
+    bool has_last_value;
+    bool always_apply;            // Some observer can go stale without a notification
+    bool float_exact;             // Some observer needs exact float comparison
+    int8_t float_digits;          // Decimal digits the observers can show, -1 if none yet
+    binding_value_t last_value;
+    char* last_string;            // Owned copy of a string last_value
+    size_t last_string_cap;
+    // Counters for data_binding_get_stats(), updated while stats are enabled
+    uint32_t stat_notifies;
+    uint32_t stat_applies;
+    uint32_t stat_widget_updates;
+    uint64_t stat_invalidated_area;
+    // Derived states
+    int32_t derived_expr;         // Index into `derived_exprs` if this state is derived, else -1
+    int32_t first_dependent;      // Index into `derived_edges`, -1 if no expression reads this state
+    bool has_value;               // Only tracked while first_dependent >= 0
+    binding_value_t value;        // Exact current value, as read by the expressions
+    char* value_string;           // Owned copy of a string value
+    size_t value_string_cap;
+    uint32_t visit_mark;          // Cycle check bookkeeping
+} StateEntry;
+
+// States, indexed by data_binding_state_handle_t.
+static StateEntry* states = NULL;
+static uint32_t state_count = 0;
+static uint32_t state_capacity = 0;
+
+// Open-addressing index from state name to `states` slot. Its size is a power
+// of two kept at least twice the state capacity, so the load factor stays <= 0.5.
+static uint32_t* state_index = NULL; // Holds slot + 1; 0 marks an empty bucket.
+static uint32_t state_index_size = 0;
+
+// Observer pool, stored as parallel arrays. The notify loop walks a group's
+// members through `observer_next`, touching only the entries it needs. An
+// observer is unlinked from its group when its widget is deleted, so the loop
+// only ever sees live widgets. Unlinked entries are kept on a free list,
+// chained through `observer_prev`, and reused by later observers.
+static lv_obj_t** observer_widgets = NULL;
+static int32_t* observer_group = NULL;          // Group the observer belongs to, -1 if free
+static int32_t* observer_next = NULL;           // Next member of the same group, -1 at the end
+static int32_t* observer_prev = NULL;           // Previous member, or next free entry once unlinked
+static lv_style_t** observer_last_style = NULL; // STYLE only: style currently on the widget
+static uint32_t observer_count = 0;
+static uint32_t observer_capacity = 0;
+static int32_t observer_free_head = -1;
+
+static ObserverGroup* observer_groups = NULL;
+static uint32_t group_count = 0;
+static uint32_t group_capacity = 0;
+
+// Action names, indexed by data_binding_action_id_t. The names live in the arena.
+typedef struct {
+    const char* name;
+    uint32_t name_hash;
+} ActionName;
+
+static ActionName* actions = NULL;
+static uint32_t action_count = 0;
+static uint32_t action_capacity = 0;
+
+// Derived states. Each expression is a copied postfix program; `derived_edges`
+// links every input state to the expressions that read it. An expression's
+// level is one more than the highest level among its inputs (plain states are
+// level 0), so evaluating dirty expressions lowest level first visits each one
+// once, after all of its inputs are final.
+typedef struct {
+    data_binding_state_handle_t state;
+    const binding_expr_instr_t* code;
+    uint32_t code_len;
+    const binding_value_t* consts;
+    const data_binding_state_handle_t* inputs;
+    uint32_t level;
+    bool is_dirty;
+} DerivedExpr;
+
+typedef struct {
+    int32_t expr; // Index into `derived_exprs`
+    int32_t next; // Next expression reading the same state, -1 at the end
+} DerivedEdge;
+
+static DerivedExpr* derived_exprs = NULL;
+static uint32_t derived_count = 0;
+static uint32_t derived_capacity = 0;
+static DerivedEdge* derived_edges = NULL;
+static uint32_t derived_edge_count = 0;
+static uint32_t derived_edge_capacity = 0;
+static int32_t* derived_dirty = NULL; // Dirty expressions, unordered; sized like derived_exprs
+static uint32_t derived_dirty_count = 0;
+static uint32_t derived_hold = 0;     // Evaluation is postponed while non-zero
+static uint32_t derived_visit_mark = 0;
+
+// States with a deferred value, in the order they were first notified.
+static int32_t pending_head = -1;
+static int32_t pending_tail = -1;
+static uint32_t batch_depth = 0;
+static lv_timer_t* frame_flush_timer = NULL;
+
+// Statistics. While a state's observers run, `stats_active_state` names it so
+// the display's invalidation callback can charge the area to it.
+static bool stats_enabled = false;
+static data_binding_state_handle_t stats_active_state = DATA_BINDING_INVALID_STATE;
+
+// Cross-thread post queue: a bounded multi-producer, single-consumer ring.
+// Each slot's sequence number tells producers and the consumer whose turn it
+// is. It is stored relative to the slot index, so the zero-initialized queue
+// is already valid before data_binding_init() runs.
+#if (DATA_BINDING_POST_QUEUE_SIZE & (DATA_BINDING_POST_QUEUE_SIZE - 1)) != 0
+#error "DATA_BINDING_POST_QUEUE_SIZE must be a power of two"
+#endif
+#define POST_QUEUE_MASK ((size_t)DATA_BINDING_POST_QUEUE_SIZE - 1)
+
+typedef struct {
+    atomic_size_t sequence; // Minus the slot index
+    data_binding_state_handle_t handle;
+    binding_value_t value;
+    char string[DATA_BINDING_POST_STRING_MAX];
+} PostSlot;
+
+static PostSlot post_slots[DATA_BINDING_POST_QUEUE_SIZE];
+static atomic_size_t post_enqueue_pos;
+static size_t post_dequeue_pos; // Only touched by the LVGL thread
+static atomic_uint post_dropped;
+static lv_timer_t* post_drain_timer = NULL;
+
+// --- Binding Arena ---
+
+// Observer and action configs live as long as the UI they were created for, so
+// they are bump-allocated from a chain of blocks and released together by
+// data_binding_init(), instead of one malloc/free pair per config.
+typedef struct BindingArenaBlock {
+    struct BindingArenaBlock* next;
+    size_t size; // Usable bytes in `data`
+    size_t used;
+    max_align_t data[];
+} BindingArenaBlock;
+
+static BindingArenaBlock* binding_arena = NULL; // Block being filled, heads the chain
+
+// Shared storage for bool configs and defaults, which need no allocation.
+static const bool bool_constants[2] = { false, true };
+
+static void* arena_alloc_aligned(size_t size, size_t align) {
+    if (size == 0) size = 1;
+    BindingArenaBlock* block = binding_arena;
+    size_t offset = block ? (block->used + align - 1) & ~(align - 1) : 0;
+    if (!block || offset + size > block->size) {
+        bool dedicated = size > BINDING_ARENA_BLOCK_SIZE / 4;
+        size_t block_size = dedicated ? size : BINDING_ARENA_BLOCK_SIZE;
+        BindingArenaBlock* new_block = malloc(sizeof(BindingArenaBlock) + block_size);
+        if (!new_block) render_abort("Failed to grow binding arena");
+        new_block->size = block_size;
+        new_block->used = 0;
+        if (dedicated && block) { // Keep filling the current block afterwards
+            new_block->next = block->next;
+            block->next = new_block;
+        } else {
+            new_block->next = block;
+            binding_arena = new_block;
+        }
+        block = new_block;
+        offset = 0;
+    }
+    block->used = offset + size;
+    return (char*)block->data + offset;
+}
+
+static void* arena_alloc(size_t size) {
+    return arena_alloc_aligned(size, _Alignof(max_align_t));
+}
+
+static void* arena_calloc(size_t count, size_t size) {
+    void* p = arena_alloc(count * size);
+    memset(p, 0, count * size);
+    return p;
+}
+
+static char* arena_strdup(const char* str) {
+    size_t len = strlen(str) + 1;
+    char* copy = arena_alloc_aligned(len, 1);
+    memcpy(copy, str, len);
+    return copy;
+}
 
-static StateObserverMapping state_observers[MAX_STATES];
-static uint32_t state_observer_count = 0;
+static void arena_release(void) {
+    while (binding_arena) {
+        BindingArenaBlock* next = binding_arena->next;
+        free(binding_arena);
+        binding_arena = next;
+    }
+}
 
 // --- Internal Structs for Dialog Action ---
 
@@ -52,6 +319,7 @@ typedef struct {
     lv_obj_t* value_label;
     lv_obj_t* scale_min_label;
     lv_obj_t* scale_max_label;
+    data_binding_action_id_t action_id;
     char* action_name;
     const NumericDialogConfig* dialog_config;
 } DialogEventData;
@@ -59,44 +327,787 @@ typedef struct {
 
 // --- Unified Action User Data Structure ---
 
-typedef struct {
+typedef int32_t (*value_getter_t)(const lv_obj_t* widget);
+
+typedef struct ActionUserData {
     action_type_t type;
-    const char* action_name;
+    data_binding_action_id_t action_id;
+    const char* action_name; // Owned by the action registry
+    lv_obj_t* widget;
     // For ACTION_TYPE_CYCLE
     binding_value_t* values;
     uint32_t value_count;
     uint32_t current_index;
     // For ACTION_TYPE_NUMERIC_DIALOG
     void* config_data;
+    // For ACTION_TYPE_VALUE
+    value_getter_t getter;
+    // Rate limiting (throttle_ms / debounce_ms). `timer` is paused while idle.
+    uint32_t throttle_ms;
+    uint32_t debounce_ms;
+    uint32_t last_dispatch_tick;
+    bool has_dispatched;
+    bool has_pending;
+    bool timer_armed;
+    binding_value_t pending_value;
+    lv_timer_t* timer;
+    struct ActionUserData* next_limited; // Next entry in `rate_limited_actions`
 } ActionUserData;
 
 
 // --- Module-level variables ---
 static data_binding_action_handler_t app_action_handler = NULL;
 static void* app_user_data = NULL;
+static data_binding_action_id_handler_t app_action_id_handler = NULL;
+static void* app_action_id_user_data = NULL;
+
+// Actions with a throttle or debounce, each owning an LVGL timer.
+static ActionUserData* rate_limited_actions = NULL;
 
 // --- Forward Declarations for Event Callbacks ---
 static void generic_action_event_cb(lv_event_t* e);
-static void free_action_user_data_cb(lv_event_t* e);
-static void free_observer_config_cb(lv_event_t* e);
+static void action_widget_deleted_cb(lv_event_t* e);
+static void action_rate_timer_cb(lv_timer_t* timer);
+static void observer_widget_deleted_cb(lv_event_t* e);
+static void apply_state_value(data_binding_state_handle_t handle, binding_value_t new_value);
+static void update_expr_input(data_binding_state_handle_t handle, const binding_value_t* new_value);
+static void run_derived_updates(void);
 static void create_and_show_numeric_dialog(ActionUserData* user_data);
+static void drain_post_queue(bool apply);
+
+// --- Value Setter Registry ---
+
+typedef struct {
+    const lv_obj_class_t* cls;
+    data_binding_value_setter_t setter;
+} ValueSetterEntry;
+
+#if LV_USE_BAR
+static void set_bar_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) { lv_bar_set_value(widget, value, anim); }
+#endif
+#if LV_USE_SLIDER
+static void set_slider_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) { lv_slider_set_value(widget, value, anim); }
+#endif
+#if LV_USE_ARC
+// lv_arc_set_value doesn't have an anim parameter
+static void set_arc_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) { (void)anim; lv_arc_set_value(widget, value); }
+#endif
+#if LV_USE_SPINBOX
+static void set_spinbox_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) { (void)anim; lv_spinbox_set_value(widget, value); }
+#endif
+#if LV_USE_ROLLER
+static void set_roller_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) { lv_roller_set_selected(widget, value < 0 ? 0 : (uint32_t)value, anim); }
+#endif
+#if LV_USE_DROPDOWN
+static void set_dropdown_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) { (void)anim; lv_dropdown_set_selected(widget, value < 0 ? 0 : (uint32_t)value); }
+#endif
+#if LV_USE_LED
+static void set_led_value(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim) {
+    (void)anim;
+    lv_led_set_brightness(widget, (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value)));
+}
+#endif
+
+static const ValueSetterEntry builtin_value_setters[] = {
+#if LV_USE_BAR
+    { &lv_bar_class, set_bar_value },
+#endif
+#if LV_USE_SLIDER
+    { &lv_slider_class, set_slider_value },
+#endif
+#if LV_USE_ARC
+    { &lv_arc_class, set_arc_value },
+#endif
+#if LV_USE_SPINBOX
+    { &lv_spinbox_class, set_spinbox_value },
+#endif
+#if LV_USE_ROLLER
+    { &lv_roller_class, set_roller_value },
+#endif
+#if LV_USE_DROPDOWN
+    { &lv_dropdown_class, set_dropdown_value },
+#endif
+#if LV_USE_LED
+    { &lv_led_class, set_led_value },
+#endif
+    { NULL, NULL }
+};
+
+// Setters registered by the application. They take precedence over the
+// built-ins and survive data_binding_init(), like the classes they describe.
+static ValueSetterEntry* custom_value_setters = NULL;
+static uint32_t custom_value_setter_count = 0;
+
+void data_binding_register_value_setter(const lv_obj_class_t* cls, data_binding_value_setter_t setter) {
+    if (!cls) return;
+    for (uint32_t i = 0; i < custom_value_setter_count; i++) {
+        if (custom_value_setters[i].cls == cls) {
+            custom_value_setters[i].setter = setter;
+            return;
+        }
+    }
+    ValueSetterEntry* grown = realloc(custom_value_setters, (custom_value_setter_count + 1) * sizeof(ValueSetterEntry));
+    if (!grown) render_abort("Failed to grow value setter registry");
+    custom_value_setters = grown;
+    custom_value_setters[custom_value_setter_count++] = (ValueSetterEntry){ cls, setter };
+}
+
+static data_binding_value_setter_t find_setter_for_class(const ValueSetterEntry* entries, uint32_t count, const lv_obj_t* widget, bool exact) {
+    for (uint32_t i = 0; i < count && entries[i].cls; i++) {
+        bool match = exact ? lv_obj_get_class(widget) == entries[i].cls : lv_obj_has_class(widget, entries[i].cls);
+        if (match) return entries[i].setter;
+    }
+    return NULL;
+}
+
+// Finds the setter for the widget's class. An exact class match wins over a
+// base class match, so a slider gets the slider setter rather than the bar one.
+static data_binding_value_setter_t resolve_value_setter(const lv_obj_t* widget) {
+    uint32_t builtin_count = sizeof(builtin_value_setters) / sizeof(builtin_value_setters[0]);
+    for (int pass = 0; pass < 2; pass++) {
+        bool exact = (pass == 0);
+        data_binding_value_setter_t setter = find_setter_for_class(custom_value_setters, custom_value_setter_count, widget, exact);
+        if (!setter) setter = find_setter_for_class(builtin_value_setters, builtin_count, widget, exact);
+        if (setter) return setter;
+    }
+    return NULL;
+}
+
+// --- Value Getters (for 'value' actions) ---
+
+typedef struct {
+    const lv_obj_class_t* cls;
+    value_getter_t getter;
+} ValueGetterEntry;
+
+#if LV_USE_BAR
+static int32_t get_bar_value(const lv_obj_t* widget) { return lv_bar_get_value(widget); }
+#endif
+#if LV_USE_SLIDER
+static int32_t get_slider_value(const lv_obj_t* widget) { return lv_slider_get_value(widget); }
+#endif
+#if LV_USE_ARC
+static int32_t get_arc_value(const lv_obj_t* widget) { return lv_arc_get_value(widget); }
+#endif
+#if LV_USE_SPINBOX
+static int32_t get_spinbox_value(const lv_obj_t* widget) { return lv_spinbox_get_value((lv_obj_t*)widget); }
+#endif
+#if LV_USE_ROLLER
+static int32_t get_roller_value(const lv_obj_t* widget) { return (int32_t)lv_roller_get_selected(widget); }
+#endif
+#if LV_USE_DROPDOWN
+static int32_t get_dropdown_value(const lv_obj_t* widget) { return (int32_t)lv_dropdown_get_selected(widget); }
+#endif
+
+static const ValueGetterEntry builtin_value_getters[] = {
+#if LV_USE_BAR
+    { &lv_bar_class, get_bar_value },
+#endif
+#if LV_USE_SLIDER
+    { &lv_slider_class, get_slider_value },
+#endif
+#if LV_USE_ARC
+    { &lv_arc_class, get_arc_value },
+#endif
+#if LV_USE_SPINBOX
+    { &lv_spinbox_class, get_spinbox_value },
+#endif
+#if LV_USE_ROLLER
+    { &lv_roller_class, get_roller_value },
+#endif
+#if LV_USE_DROPDOWN
+    { &lv_dropdown_class, get_dropdown_value },
+#endif
+    { NULL, NULL }
+};
+
+// Same lookup order as resolve_value_setter(): exact class first, then base class.
+static value_getter_t resolve_value_getter(const lv_obj_t* widget) {
+    for (int pass = 0; pass < 2; pass++) {
+        for (const ValueGetterEntry* entry = builtin_value_getters; entry->cls; entry++) {
+            bool match = pass == 0 ? lv_obj_get_class(widget) == entry->cls : lv_obj_has_class(widget, entry->cls);
+            if (match) return entry->getter;
+        }
+    }
+    return NULL;
+}
+
+// --- Observer Maps ---
+
+// Largest span of integral keys stored in the dense table. Wider key ranges
+// would waste memory, so those keys are scanned instead.
+#define MAP_DENSE_MAX_SPAN 64
+
+static int compare_string_key_slots(const void* a, const void* b) {
+    const StringKeySlot* sa = a;
+    const StringKeySlot* sb = b;
+    int cmp = strcmp(sa->key, sb->key);
+    if (cmp != 0) return cmp;
+    return (sa->entry > sb->entry) - (sa->entry < sb->entry);
+}
+
+// --- Numeric Values ---
+
+static bool is_integer_type(binding_value_type_t type) {
+    return type == BINDING_TYPE_INT || type == BINDING_TYPE_INT64;
+}
+
+static bool is_numeric_type(binding_value_type_t type) {
+    return type == BINDING_TYPE_FLOAT || type == BINDING_TYPE_DOUBLE || is_integer_type(type);
+}
+
+// Integer types only.
+static int64_t value_as_int64(const binding_value_t* value) {
+    return value->type == BINDING_TYPE_INT ? value->as.i_val : value->as.i64_val;
+}
+
+// Numeric types only.
+static double value_as_double(const binding_value_t* value) {
+    switch (value->type) {
+        case BINDING_TYPE_FLOAT:  return value->as.f_val;
+        case BINDING_TYPE_DOUBLE: return value->as.d_val;
+        default:                  return (double)value_as_int64(value);
+    }
+}
+
+// Rounds a numeric value to int32_t, saturating at the limits. Integers never
+// go through floating point.
+static int32_t value_to_int32(const binding_value_t* value) {
+    if (is_integer_type(value->type)) {
+        int64_t i = value_as_int64(value);
+        return i > INT32_MAX ? INT32_MAX : (i < INT32_MIN ? INT32_MIN : (int32_t)i);
+    }
+    double d = value_as_double(value);
+    if (isnan(d)) return 0;
+    if (d >= (double)INT32_MAX) return INT32_MAX;
+    if (d <= (double)INT32_MIN) return INT32_MIN;
+    return (int32_t)lround(d);
+}
+
+static bool value_is_truthy(const binding_value_t* value) {
+    switch (value->type) {
+        case BINDING_TYPE_BOOL:   return value->as.b_val;
+        case BINDING_TYPE_STRING: return value->as.s_val && *value->as.s_val != '\0';
+        case BINDING_TYPE_INT:
+        case BINDING_TYPE_INT64:  return value_as_int64(value) != 0;
+        case BINDING_TYPE_FLOAT:
+        case BINDING_TYPE_DOUBLE: return value_as_double(value) != 0.0;
+        default:                  return false;
+    }
+}
+
+// Equality of two numeric values of any type. A float and a double are
+// compared at float precision, since float map keys come from decimal literals.
+static bool numeric_values_equal(const binding_value_t* a, const binding_value_t* b) {
+    if (is_integer_type(a->type) && is_integer_type(b->type)) return value_as_int64(a) == value_as_int64(b);
+    if ((a->type == BINDING_TYPE_FLOAT && b->type == BINDING_TYPE_DOUBLE) ||
+        (a->type == BINDING_TYPE_DOUBLE && b->type == BINDING_TYPE_FLOAT)) {
+        return (float)value_as_double(a) == (float)value_as_double(b);
+    }
+    return value_as_double(a) == value_as_double(b);
+}
+
+// True if the numeric value is an integer within the range of the dense map
+// tables, which is then stored in `key`.
+static bool numeric_dense_key(const binding_value_t* value, int32_t* key) {
+    if (is_integer_type(value->type)) {
+        int64_t i = value_as_int64(value);
+        if (i < INT16_MIN || i > INT16_MAX) return false;
+        *key = (int32_t)i;
+        return true;
+    }
+    double d = value_as_double(value);
+    if (!(d >= INT16_MIN && d <= INT16_MAX) || d != (double)(int32_t)d) return false;
+    *key = (int32_t)d;
+    return true;
+}
+
+// With `borrow`, the entries and their string keys are used in place and must
+// outlive the observer, as the static const tables of generated code do.
+static ObserverMap* compile_observer_map(const binding_map_entry_t* src, size_t count, bool borrow) {
+    ObserverMap* map = arena_calloc(1, sizeof(ObserverMap));
+    if (borrow) {
+        map->entries = src;
+    } else {
+        binding_map_entry_t* entries = arena_alloc(count * sizeof(binding_map_entry_t));
+        memcpy(entries, src, count * sizeof(binding_map_entry_t));
+        for (size_t i = 0; i < count; i++) {
+            if (entries[i].key.type == BINDING_TYPE_STRING && entries[i].key.as.s_val) {
+                entries[i].key.as.s_val = arena_strdup(entries[i].key.as.s_val);
+            }
+        }
+        map->entries = entries;
+    }
+    map->entry_count = (uint32_t)count;
+    map->bool_entry[0] = map->bool_entry[1] = -1;
+
+    uint32_t string_count = 0, numeric_count = 0;
+    int32_t dense_min = INT32_MAX, dense_max = INT32_MIN;
+    for (uint32_t i = 0; i < map->entry_count; i++) {
+        const binding_value_t* key = &map->entries[i].key;
+        if (key->type == BINDING_TYPE_STRING && key->as.s_val) {
+            string_count++;
+        } else if (key->type == BINDING_TYPE_BOOL) {
+            if (map->bool_entry[key->as.b_val] < 0) map->bool_entry[key->as.b_val] = (int32_t)i;
+        } else if (is_numeric_type(key->type)) {
+            numeric_count++;
+            int32_t k;
+            if (numeric_dense_key(key, &k)) {
+                if (k < dense_min) dense_min = k;
+                if (k > dense_max) dense_max = k;
+            }
+        }
+    }
+
+    if (string_count > 0) {
+        map->string_keys = arena_alloc(string_count * sizeof(StringKeySlot));
+        for (uint32_t i = 0; i < map->entry_count; i++) {
+            const binding_value_t* key = &map->entries[i].key;
+            if (key->type == BINDING_TYPE_STRING && key->as.s_val) {
+                map->string_keys[map->string_key_count++] = (StringKeySlot){ key->as.s_val, i };
+            }
+        }
+        qsort(map->string_keys, map->string_key_count, sizeof(StringKeySlot), compare_string_key_slots);
+        // Drop later duplicates; the sort put the first one in map order first.
+        uint32_t unique = 0;
+        for (uint32_t i = 0; i < map->string_key_count; i++) {
+            if (unique > 0 && strcmp(map->string_keys[unique - 1].key, map->string_keys[i].key) == 0) continue;
+            map->string_keys[unique++] = map->string_keys[i];
+        }
+        map->string_key_count = unique;
+    }
+
+    if (numeric_count > 0) {
+        bool use_dense = dense_min <= dense_max && (int64_t)dense_max - dense_min < MAP_DENSE_MAX_SPAN;
+        if (use_dense) {
+            map->dense_min = dense_min;
+            map->dense_len = (uint32_t)(dense_max - dense_min + 1);
+            map->dense_entry = arena_alloc(map->dense_len * sizeof(int32_t));
+            for (uint32_t i = 0; i < map->dense_len; i++) map->dense_entry[i] = -1;
+        }
+        for (uint32_t i = 0; i < map->entry_count; i++) {
+            const binding_value_t* key = &map->entries[i].key;
+            if (!is_numeric_type(key->type)) continue;
+            int32_t k;
+            if (use_dense && numeric_dense_key(key, &k)) {
+                int32_t* slot = &map->dense_entry[k - map->dense_min];
+                if (*slot < 0) *slot = (int32_t)i;
+            } else {
+                if (!map->sparse_numeric_entry) {
+                    map->sparse_numeric_entry = arena_alloc(numeric_count * sizeof(uint32_t));
+                }
+                map->sparse_numeric_entry[map->sparse_numeric_count++] = i;
+            }
+        }
+    }
+    return map;
+}
+
+// Returns the entry whose key equals `value`, or NULL.
+static const binding_map_entry_t* observer_map_lookup(const ObserverMap* map, const binding_value_t* value) {
+    if (!map) return NULL;
+    switch (value->type) {
+        case BINDING_TYPE_BOOL: {
+            int32_t entry = map->bool_entry[value->as.b_val ? 1 : 0];
+            return entry >= 0 ? &map->entries[entry] : NULL;
+        }
+        case BINDING_TYPE_STRING: {
+            if (!value->as.s_val) return NULL;
+            uint32_t lo = 0, hi = map->string_key_count;
+            while (lo < hi) {
+                uint32_t mid = lo + (hi - lo) / 2;
+                int cmp = strcmp(value->as.s_val, map->string_keys[mid].key);
+                if (cmp == 0) return &map->entries[map->string_keys[mid].entry];
+                if (cmp < 0) hi = mid;
+                else lo = mid + 1;
+            }
+            return NULL;
+        }
+        case BINDING_TYPE_FLOAT:
+        case BINDING_TYPE_DOUBLE:
+        case BINDING_TYPE_INT:
+        case BINDING_TYPE_INT64: {
+            // Map keys match exactly, as written in the UI spec.
+            int32_t k;
+            if (map->dense_entry && numeric_dense_key(value, &k)) {
+                int64_t offset = (int64_t)k - map->dense_min;
+                if (offset >= 0 && offset < (int64_t)map->dense_len && map->dense_entry[offset] >= 0) {
+                    return &map->entries[map->dense_entry[offset]];
+                }
+            }
+            for (uint32_t i = 0; i < map->sparse_numeric_count; i++) {
+                const binding_map_entry_t* entry = &map->entries[map->sparse_numeric_entry[i]];
+                if (numeric_values_equal(&entry->key, value)) return entry;
+            }
+            return NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+// --- Text Formatters ---
+
+// Copies fmt[start, end) with "%%" unescaped. With `borrow`, a range without
+// "%%" is returned in place; the literals are used with their length only.
+static const char* copy_literal(const char* fmt, size_t start, size_t end, size_t* out_len, bool borrow) {
+    if (borrow) {
+        bool has_escape = false;
+        for (size_t i = start; i + 1 < end; i++) {
+            if (fmt[i] == '%' && fmt[i + 1] == '%') { has_escape = true; break; }
+        }
+        if (!has_escape) {
+            *out_len = end - start;
+            return fmt + start;
+        }
+    }
+    char* out = arena_alloc_aligned(end - start + 1, 1);
+    size_t n = 0;
+    for (size_t i = start; i < end; i++) {
+        out[n++] = fmt[i];
+        if (fmt[i] == '%' && i + 1 < end && fmt[i + 1] == '%') i++;
+    }
+    out[n] = '\0';
+    *out_len = n;
+    return out;
+}
+
+// With `borrow`, fmt is referenced rather than copied and must outlive the observer.
+static TextFormatter* compile_text_formatter(const char* fmt, bool borrow) {
+    TextFormatter* f = arena_calloc(1, sizeof(TextFormatter));
+    f->format = borrow ? fmt : arena_strdup(fmt);
+    f->precision = -1;
+    f->kind = TEXT_FORMAT_GENERIC;
+
+    // Locate the conversions, skipping "%%".
+    size_t len = strlen(fmt);
+    size_t spec_start = 0, spec_end = 0;
+    int spec_count = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (fmt[i] != '%') continue;
+        if (fmt[i + 1] == '%') { i++; continue; }
+        if (spec_count++ == 0) spec_start = i;
+    }
+    if (spec_count == 0) {
+        f->kind = TEXT_FORMAT_LITERAL;
+        f->prefix = copy_literal(fmt, 0, len, &f->prefix_len, borrow);
+        return f;
+    }
+
+    // Parse the first conversion: flags, width, precision, conversion character.
+    const char* p = fmt + spec_start + 1;
+    bool has_alt_form = false;
+    for (;; p++) {
+        if (*p == '-') f->left_align = true;
+        else if (*p == '+') f->plus_sign = true;
+        else if (*p == ' ') f->space_sign = true;
+        else if (*p == '0') f->zero_pad = true;
+        else if (*p == '#') has_alt_form = true;
+        else break;
+    }
+    int width = 0;
+    while (*p >= '0' && *p <= '9') width = width * 10 + (*p++ - '0');
+    if (*p == '.') {
+        int precision = 0;
+        for (p++; *p >= '0' && *p <= '9'; p++) precision = precision * 10 + (*p - '0');
+        f->precision = (int8_t)(precision > 100 ? 100 : precision);
+    }
+    f->conversion = *p;
+    if (*p) p++;
+    spec_end = (size_t)(p - fmt);
+
+    if (spec_count > 1 || has_alt_form || width > 64) return f; // GENERIC
+
+    f->width = (uint8_t)width;
+    f->prefix = copy_literal(fmt, 0, spec_start, &f->prefix_len, borrow);
+    f->suffix = copy_literal(fmt, spec_end, len, &f->suffix_len, borrow);
+
+    switch (f->conversion) {
+        case 's':
+            if (width == 0 && f->precision < 0) f->kind = TEXT_FORMAT_STRING;
+            break;
+        case 'd': case 'i':
+            if (f->precision < 0) f->kind = TEXT_FORMAT_INT;
+            break;
+        case 'f': case 'F':
+            if (f->precision < 0) f->precision = 6;
+            if (f->precision <= 9) f->kind = TEXT_FORMAT_FIXED;
+            break;
+        default:
+            break;
+    }
+    return f;
+}
+
+typedef struct {
+    char* buf;
+    size_t cap; // Includes the terminator
+    size_t len;
+} TextOut;
+
+static void out_append(TextOut* out, const char* str, size_t n) {
+    size_t room = out->cap - 1 - out->len;
+    if (n > room) n = room;
+    if (n == 0) return;
+    memcpy(out->buf + out->len, str, n);
+    out->len += n;
+}
+
+static void out_fill(TextOut* out, char c, size_t n) {
+    while (n-- > 0 && out->len < out->cap - 1) out->buf[out->len++] = c;
+}
+
+// Writes a sign and digit string with printf's width and flag semantics.
+static void out_padded_number(TextOut* out, const TextFormatter* f, bool negative, const char* digits, size_t digit_len) {
+    char sign = negative ? '-' : (f->plus_sign ? '+' : (f->space_sign ? ' ' : 0));
+    size_t body_len = digit_len + (sign ? 1 : 0);
+    size_t pad = f->width > body_len ? f->width - body_len : 0;
+
+    if (!f->left_align && !f->zero_pad) out_fill(out, ' ', pad);
+    if (sign) out_append(out, &sign, 1);
+    if (!f->left_align && f->zero_pad) out_fill(out, '0', pad);
+    out_append(out, digits, digit_len);
+    if (f->left_align) out_fill(out, ' ', pad);
+}
+
+// Writes `value` in decimal to the end of `end`, returning the start.
+static char* format_u64_backwards(char* end, unsigned long long value) {
+    do {
+        *--end = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return end;
+}
+
+static const double pow10_table[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+// Renders a float or double with the FIXED formatter. Returns false if it is
+// out of the range the integer path handles, so the caller can fall back to snprintf.
+static bool format_fixed(TextOut* out, const TextFormatter* f, double value) {
+    double scaled = fabs(value) * pow10_table[f->precision];
+    if (!(scaled < 9.0e18)) return false; // Also rejects NaN and infinities
+    // llrint rounds half to even, like glibc's printf on exact ties.
+    unsigned long long units = (unsigned long long)llrint(scaled);
+    unsigned long long divisor = (unsigned long long)pow10_table[f->precision];
+
+    char digits[48];
+    char* end = digits + sizeof(digits);
+    char* start = end;
+    if (f->precision > 0) {
+        unsigned long long frac = units % divisor;
+        for (int i = 0; i < f->precision; i++) {
+            *--start = (char)('0' + frac % 10);
+            frac /= 10;
+        }
+        *--start = '.';
+    }
+    start = format_u64_backwards(start, units / divisor);
+
+    // printf keeps the sign of negative values that round to zero ("-0.00").
+    out_padded_number(out, f, signbit(value) != 0, start, (size_t)(end - start));
+    return true;
+}
+
+// Renders an integer with the FIXED formatter: the digits followed by a zero
+// fraction, without any floating point.
+static void format_fixed_integer(TextOut* out, const TextFormatter* f, long long value) {
+    char digits[40];
+    char* end = digits + sizeof(digits);
+    char* start = end;
+    if (f->precision > 0) {
+        for (int i = 0; i < f->precision; i++) *--start = '0';
+        *--start = '.';
+    }
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    start = format_u64_backwards(start, magnitude);
+    out_padded_number(out, f, value < 0, start, (size_t)(end - start));
+}
+
+static void format_int(TextOut* out, const TextFormatter* f, long long value) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    char* start = format_u64_backwards(end, magnitude);
+    out_padded_number(out, f, value < 0, start, (size_t)(end - start));
+}
+
+// Writes a numeric value the way "%s" shows it: integers in full, floating
+// point values with "%g". `tmp` must hold at least 32 characters.
+static const char* numeric_to_text(char* tmp, const binding_value_t* value) {
+    if (is_integer_type(value->type)) {
+        long long i = value_as_int64(value);
+        char* end = tmp + 31;
+        *end = '\0';
+        char* start = format_u64_backwards(end, i < 0 ? 0ULL - (unsigned long long)i : (unsigned long long)i);
+        if (i < 0) *--start = '-';
+        return start;
+    }
+    snprintf(tmp, 32, "%g", value_as_double(value));
+    return tmp;
+}
+
+// snprintf path, used for formats the compiled path does not cover.
+static void format_generic(TextOut* out, const TextFormatter* f, const binding_value_t* value) {
+    int written = 0;
+    switch (value->type) {
+        case BINDING_TYPE_FLOAT:
+        case BINDING_TYPE_DOUBLE:
+        case BINDING_TYPE_INT:
+        case BINDING_TYPE_INT64:
+            if (f->conversion == 's') {
+                char tmp[32];
+                written = snprintf(out->buf, out->cap, f->format, numeric_to_text(tmp, value));
+            } else if (strchr("diouxXc", f->conversion)) {
+                written = snprintf(out->buf, out->cap, f->format, (int)value_to_int32(value));
+            } else {
+                written = snprintf(out->buf, out->cap, f->format, value_as_double(value));
+            }
+            break;
+        case BINDING_TYPE_BOOL:
+        case BINDING_TYPE_STRING: {
+            const char* str = value->type == BINDING_TYPE_BOOL ? (value->as.b_val ? "true" : "false") : value->as.s_val;
+            if (f->conversion == 's') {
+                written = snprintf(out->buf, out->cap, f->format, str ? str : "");
+            } else {
+                written = snprintf(out->buf, out->cap, "%s", str ? str : "");
+            }
+            break;
+        }
+        default:
+            written = snprintf(out->buf, out->cap, "N/A");
+            break;
+    }
+    out->len = written < 0 ? 0 : ((size_t)written < out->cap ? (size_t)written : out->cap - 1);
+}
+
+// Renders `value` through the formatter into out->buf (always terminated).
+static void format_text(TextOut* out, const TextFormatter* f, const binding_value_t* value) {
+    out->len = 0;
+    if (f->kind == TEXT_FORMAT_GENERIC || value->type == BINDING_TYPE_NULL) {
+        format_generic(out, f, value);
+        out->buf[out->len] = '\0';
+        return;
+    }
+
+    out_append(out, f->prefix, f->prefix_len);
+    switch (f->kind) {
+        case TEXT_FORMAT_LITERAL:
+            break;
+        case TEXT_FORMAT_INT:
+        case TEXT_FORMAT_FIXED:
+            if (is_integer_type(value->type)) {
+                if (f->kind == TEXT_FORMAT_INT) format_int(out, f, value_as_int64(value));
+                else format_fixed_integer(out, f, value_as_int64(value));
+                break;
+            }
+            if (is_numeric_type(value->type)) {
+                double d = value_as_double(value);
+                bool in_range;
+                if (f->kind == TEXT_FORMAT_INT) {
+                    in_range = fabs(d) < 9.0e18; // Also rejects NaN and infinities
+                    if (in_range) format_int(out, f, llround(d));
+                } else {
+                    in_range = format_fixed(out, f, d);
+                }
+                if (!in_range) {
+                    format_generic(out, f, value);
+                    out->buf[out->len] = '\0';
+                    return;
+                }
+                break;
+            }
+            // Non-numeric values are shown as text in place of the number.
+            /* fall through */
+        case TEXT_FORMAT_STRING: {
+            const char* str = "";
+            char tmp[32];
+            if (value->type == BINDING_TYPE_STRING) str = value->as.s_val ? value->as.s_val : "";
+            else if (value->type == BINDING_TYPE_BOOL) str = value->as.b_val ? "true" : "false";
+            else if (is_numeric_type(value->type)) str = numeric_to_text(tmp, value);
+            out_append(out, str, strlen(str));
+            break;
+        }
+        case TEXT_FORMAT_GENERIC:
+            break;
+    }
+    out_append(out, f->suffix, f->suffix_len);
+    out->buf[out->len] = '\0';
+}
 
 // --- Public API Implementation ---
 
 void data_binding_init(void) {
     // This function needs to be safe to call multiple times for watch mode.
     // It must free any previously allocated memory.
-    for (uint32_t i = 0; i < state_observer_count; i++) {
-        free(state_observers[i].state_name);
-        // Note: The individual observer configs are freed by the LV_EVENT_DELETE
-        // callback attached to each widget. When lv_obj_clean is called, this
-        // event is triggered for all children, ensuring no memory leaks.
+    for (uint32_t i = 0; i < state_count; i++) {
+        free(states[i].state_name);
+        free(states[i].pending_string);
+        free(states[i].last_string);
+        free(states[i].value_string);
+    }
+    // Rate-limited actions live in the arena, but their timers do not.
+    for (ActionUserData* action = rate_limited_actions; action; action = action->next_limited) {
+        lv_timer_delete(action->timer);
+    }
+    rate_limited_actions = NULL;
+
+    // Observer and action configs all live in the arena. Delete callbacks of
+    // widgets that are still alive will no longer match a pool entry.
+    arena_release();
+
+    free(states);
+    free(state_index);
+    free(observer_widgets);
+    free(observer_group);
+    free(observer_next);
+    free(observer_prev);
+    free(observer_last_style);
+    free(observer_groups);
+    free(actions);
+    free(derived_exprs);
+    free(derived_edges);
+    free(derived_dirty);
+    states = NULL;
+    state_count = state_capacity = 0;
+    state_index = NULL;
+    state_index_size = 0;
+    observer_widgets = NULL;
+    observer_group = NULL;
+    observer_next = NULL;
+    observer_prev = NULL;
+    observer_last_style = NULL;
+    observer_count = observer_capacity = 0;
+    observer_free_head = -1;
+    observer_groups = NULL;
+    group_count = group_capacity = 0;
+    actions = NULL;
+    action_count = action_capacity = 0;
+    derived_exprs = NULL;
+    derived_count = derived_capacity = 0;
+    derived_edges = NULL;
+    derived_edge_count = derived_edge_capacity = 0;
+    derived_dirty = NULL;
+    derived_dirty_count = 0;
+    derived_hold = 0;
+
+    pending_head = pending_tail = -1;
+    batch_depth = 0;
+    stats_active_state = DATA_BINDING_INVALID_STATE;
+    // Posted handles refer to the old state table.
+    drain_post_queue(false);
+    if (post_drain_timer) {
+        lv_timer_delete(post_drain_timer);
+        post_drain_timer = NULL;
+    }
+    if (frame_flush_timer) {
+        lv_timer_delete(frame_flush_timer);
+        frame_flush_timer = NULL;
     }
 
-    memset(state_observers, 0, sizeof(state_observers));
-    state_observer_count = 0;
     app_action_handler = NULL;
     app_user_data = NULL;
+    app_action_id_handler = NULL;
+    app_action_id_user_data = NULL;
     DEBUG_LOG(LOG_MODULE_DATABINDING, "Data binding system (re)initialized.");
 }
 
@@ -106,278 +1117,1332 @@ void data_binding_register_action_handler(data_binding_action_handler_t handler,
     DEBUG_LOG(LOG_MODULE_DATABINDING, "Application action handler registered.");
 }
 
-static bool values_equal(const binding_value_t* v1, const binding_value_t* v2) {
-    if (v1->type != v2->type) return false;
-    switch(v1->type) {
-        case BINDING_TYPE_BOOL: return v1->as.b_val == v2->as.b_val;
-        case BINDING_TYPE_STRING: return strcmp(v1->as.s_val, v2->as.s_val) == 0;
-        // For map keys, we assume exact float matches are intended.
-        case BINDING_TYPE_FLOAT: return v1->as.f_val == v2->as.f_val;
-        default: return false;
+void data_binding_register_action_id_handler(data_binding_action_id_handler_t handler, void* user_data) {
+    app_action_id_handler = handler;
+    app_action_id_user_data = user_data;
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Application action ID handler registered.");
+}
+
+// --- State Name Index ---
+
+// 32-bit FNV-1a. Cheap to compute and distributes the short, prefix-heavy
+// names used for states ("position|x", "position|y", ...) well.
+static uint32_t hash_state_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Returns the `states` slot for the name, or -1 if it is not known.
+// Probing compares the stored 32-bit hashes; the name itself is only compared
+// once, to confirm a full hash match.
+static int find_state_slot(const char* state_name, uint32_t hash) {
+    if (state_index_size == 0) return -1;
+    uint32_t mask = state_index_size - 1;
+    uint32_t pos = hash & mask;
+    for (uint32_t probe = 0; probe < state_index_size; probe++) {
+        if (state_index[pos] == 0) return -1;
+        int slot = (int)state_index[pos] - 1;
+        if (states[slot].name_hash == hash && strcmp(states[slot].state_name, state_name) == 0) {
+            return slot;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+static void insert_state_slot(uint32_t hash, int slot) {
+    uint32_t mask = state_index_size - 1;
+    uint32_t pos = hash & mask;
+    while (state_index[pos] != 0) {
+        pos = (pos + 1) & mask;
+    }
+    state_index[pos] = (uint32_t)slot + 1;
+}
+
+// Makes room for one more state, growing the state table and rebuilding the
+// name index when it is full.
+static void reserve_state_slot(void) {
+    if (state_count < state_capacity) return;
+
+    uint32_t new_capacity = state_capacity ? state_capacity * 2 : INITIAL_STATE_CAPACITY;
+    StateEntry* new_states = realloc(states, new_capacity * sizeof(StateEntry));
+    if (!new_states) render_abort("Failed to grow data binding state table");
+    states = new_states;
+    state_capacity = new_capacity;
+
+    free(state_index);
+    state_index_size = new_capacity * 2;
+    state_index = calloc(state_index_size, sizeof(uint32_t));
+    if (!state_index) render_abort("Failed to grow data binding state index");
+    for (uint32_t i = 0; i < state_count; i++) {
+        insert_state_slot(states[i].name_hash, (int)i);
+    }
+}
+
+// Returns the index of a new, unlinked observer pool entry.
+// Grows the observer pool so that `extra` more observers fit without another
+// reallocation.
+static void reserve_observer_slots(uint32_t extra) {
+    if (observer_count + extra > observer_capacity) {
+        uint32_t new_capacity = observer_capacity ? observer_capacity * 2 : INITIAL_OBSERVER_CAPACITY;
+        while (new_capacity < observer_count + extra) new_capacity *= 2;
+        lv_obj_t** new_widgets = realloc(observer_widgets, new_capacity * sizeof(lv_obj_t*));
+        if (new_widgets) observer_widgets = new_widgets;
+        int32_t* new_group = realloc(observer_group, new_capacity * sizeof(int32_t));
+        if (new_group) observer_group = new_group;
+        int32_t* new_next = realloc(observer_next, new_capacity * sizeof(int32_t));
+        if (new_next) observer_next = new_next;
+        int32_t* new_prev = realloc(observer_prev, new_capacity * sizeof(int32_t));
+        if (new_prev) observer_prev = new_prev;
+        lv_style_t** new_styles = realloc(observer_last_style, new_capacity * sizeof(lv_style_t*));
+        if (new_styles) observer_last_style = new_styles;
+        if (!new_widgets || !new_group || !new_next || !new_prev || !new_styles) render_abort("Failed to grow data binding observer pool");
+        observer_capacity = new_capacity;
+    }
+}
+
+// Same as reserve_observer_slots(), for observer groups.
+static void reserve_observer_groups(uint32_t extra) {
+    if (group_count + extra > group_capacity) {
+        uint32_t new_capacity = group_capacity ? group_capacity * 2 : INITIAL_OBSERVER_CAPACITY;
+        while (new_capacity < group_count + extra) new_capacity *= 2;
+        ObserverGroup* new_groups = realloc(observer_groups, new_capacity * sizeof(ObserverGroup));
+        if (!new_groups) render_abort("Failed to grow data binding observer groups");
+        observer_groups = new_groups;
+        group_capacity = new_capacity;
+    }
+}
+
+// Returns the index of a new, unlinked observer pool entry, reusing one freed
+// by a deleted widget if there is any.
+static int32_t alloc_observer_slot(void) {
+    int32_t index = observer_free_head;
+    if (index >= 0) {
+        observer_free_head = observer_prev[index];
+    } else {
+        reserve_observer_slots(1);
+        index = (int32_t)observer_count++;
+    }
+    observer_widgets[index] = NULL;
+    observer_group[index] = -1;
+    observer_next[index] = -1;
+    observer_prev[index] = -1;
+    observer_last_style[index] = NULL;
+    return index;
+}
+
+// True if the widget can drift from the state's value without a notification,
+// so that the app may republish an unchanged value to put it right. A STYLE
+// observer drops its style while the widget is disabled, and the user can
+// change a checkable or clickable widget's CHECKED state or VALUE.
+static bool observer_may_go_stale(const lv_obj_t* widget, observer_update_type_t update_type) {
+    switch (update_type) {
+        case OBSERVER_TYPE_STYLE:   return true;
+        case OBSERVER_TYPE_CHECKED: return lv_obj_has_flag(widget, LV_OBJ_FLAG_CHECKABLE);
+        case OBSERVER_TYPE_VALUE:   return lv_obj_has_flag(widget, LV_OBJ_FLAG_CLICKABLE);
+        default:                    return false;
+    }
+}
+
+// Returns the index of a new group, linked at the end of the state's chain.
+static int32_t alloc_observer_group(int state_idx) {
+    reserve_observer_groups(1);
+    int32_t g = (int32_t)group_count++;
+    memset(&observer_groups[g], 0, sizeof(ObserverGroup));
+    observer_groups[g].next_group = -1;
+    observer_groups[g].first_member = -1;
+    observer_groups[g].last_member = -1;
+
+    StateEntry* entry = &states[state_idx];
+    if (entry->last_group >= 0) observer_groups[entry->last_group].next_group = g;
+    else entry->first_group = g;
+    entry->last_group = g;
+    return g;
+}
+
+// Returns the slot for the state, creating it if this is the first time the
+// name is seen.
+static int resolve_state_slot(const char* state_name) {
+    uint32_t hash = hash_state_name(state_name);
+    int slot = find_state_slot(state_name, hash);
+    if (slot >= 0) return slot;
+
+    reserve_state_slot();
+    slot = (int)state_count++;
+    StateEntry* entry = &states[slot];
+    entry->state_name = strdup(state_name);
+    if (!entry->state_name) render_abort("Failed to duplicate state name");
+    entry->name_hash = hash;
+    entry->first_group = -1;
+    entry->last_group = -1;
+    entry->is_pending = false;
+    entry->next_pending = -1;
+    entry->pending_string = NULL;
+    entry->pending_string_cap = 0;
+    entry->has_last_value = false;
+    entry->always_apply = false;
+    entry->float_exact = false;
+    entry->float_digits = -1;
+    entry->last_string = NULL;
+    entry->last_string_cap = 0;
+    entry->stat_notifies = 0;
+    entry->stat_applies = 0;
+    entry->stat_widget_updates = 0;
+    entry->stat_invalidated_area = 0;
+    entry->derived_expr = -1;
+    entry->first_dependent = -1;
+    entry->has_value = false;
+    entry->value_string = NULL;
+    entry->value_string_cap = 0;
+    entry->visit_mark = 0;
+    insert_state_slot(hash, slot);
+    return slot;
+}
+
+data_binding_state_handle_t data_binding_resolve_state(const char* state_name) {
+    if (!state_name) return DATA_BINDING_INVALID_STATE;
+    return resolve_state_slot(state_name);
+}
+
+bool data_binding_register_states(const char* const* state_names, uint32_t count) {
+    bool in_order = true;
+    for (uint32_t i = 0; i < count; i++) {
+        data_binding_state_handle_t handle = data_binding_resolve_state(state_names[i]);
+        if (handle != (data_binding_state_handle_t)i) {
+            print_warning("State '%s' resolved to handle %d, expected %u. Was data_binding_init() called before create_ui()?",
+                          state_names[i] ? state_names[i] : "(null)", (int)handle, i);
+            in_order = false;
+        }
+    }
+    return in_order;
+}
+
+// --- Action Registry ---
+
+// Action names are only looked up while actions are attached, and a UI has few
+// of them, so a linear scan over the stored hashes is enough.
+data_binding_action_id_t data_binding_resolve_action(const char* action_name) {
+    if (!action_name) return DATA_BINDING_INVALID_ACTION;
+    uint32_t hash = hash_state_name(action_name);
+    for (uint32_t i = 0; i < action_count; i++) {
+        if (actions[i].name_hash == hash && strcmp(actions[i].name, action_name) == 0) {
+            return (data_binding_action_id_t)i;
+        }
+    }
+
+    if (action_count == action_capacity) {
+        uint32_t new_capacity = action_capacity ? action_capacity * 2 : INITIAL_STATE_CAPACITY;
+        ActionName* new_names = realloc(actions, new_capacity * sizeof(ActionName));
+        if (!new_names) render_abort("Failed to grow data binding action table");
+        actions = new_names;
+        action_capacity = new_capacity;
+    }
+    actions[action_count].name = arena_strdup(action_name);
+    actions[action_count].name_hash = hash;
+    return (data_binding_action_id_t)action_count++;
+}
+
+const char* data_binding_get_action_name(data_binding_action_id_t action_id) {
+    if (action_id < 0 || (uint32_t)action_id >= action_count) return NULL;
+    return actions[action_id].name;
+}
+
+bool data_binding_register_actions(const char* const* action_names, uint32_t count) {
+    bool in_order = true;
+    for (uint32_t i = 0; i < count; i++) {
+        data_binding_action_id_t id = data_binding_resolve_action(action_names[i]);
+        if (id != (data_binding_action_id_t)i) {
+            print_warning("Action '%s' resolved to ID %d, expected %u. Was data_binding_init() called before create_ui()?",
+                          action_names[i] ? action_names[i] : "(null)", (int)id, i);
+            in_order = false;
+        }
+    }
+    return in_order;
+}
+
+static void dispatch_action(data_binding_action_id_t action_id, const char* action_name, binding_value_t value) {
+    if (app_action_id_handler) {
+        app_action_id_handler(action_id, value, app_action_id_user_data);
+    }
+    if (app_action_handler) {
+        app_action_handler(action_name, value, app_user_data);
     }
 }
 
 void data_binding_notify_state_changed(const char* state_name, binding_value_t new_value) {
     DEBUG_LOG(LOG_MODULE_DATABINDING, "Notification received for state: '%s'", state_name);
-    for (uint32_t i = 0; i < state_observer_count; ++i) {
-        if (strcmp(state_observers[i].state_name, state_name) == 0) {
-            for(uint32_t j = 0; j < state_observers[i].observer_count; ++j) {
-                Observer* obs = &state_observers[i].observers[j];
-                if (!lv_obj_is_valid(obs->widget)) continue;
-
-                switch (obs->config.update_type) {
-                    case OBSERVER_TYPE_TEXT: {
-                        char buf[128];
-                        const char* fmt = (const char*)obs->config.config;
-                        if (!fmt) fmt = "%s";
-
-                        switch(new_value.type) {
-                            case BINDING_TYPE_FLOAT:
-                                if (strstr(fmt, "%d") || strstr(fmt, "%i") || strstr(fmt, "%u") || strstr(fmt, "%x")) {
-                                    snprintf(buf, sizeof(buf), fmt, (int)round(new_value.as.f_val));
-                                } else {
-                                    snprintf(buf, sizeof(buf), fmt, new_value.as.f_val);
-                                }
-                                break;
-                            case BINDING_TYPE_BOOL:   snprintf(buf, sizeof(buf), fmt, new_value.as.b_val ? "true" : "false"); break;
-                            case BINDING_TYPE_STRING: snprintf(buf, sizeof(buf), fmt, new_value.as.s_val); break;
-                            default:                  strncpy(buf, "N/A", sizeof(buf)); break;
-                        }
-                        lv_label_set_text(obs->widget, buf);
-                        break;
-                    }
-                    case OBSERVER_TYPE_VALUE: {
-                        if (new_value.type != BINDING_TYPE_FLOAT) {
-                             print_warning("State '%s' sent non-numeric data to a 'value' binding.", state_name);
-                             continue;
-                        }
-
-                        int32_t val = (int32_t)round(new_value.as.f_val);
-                        lv_anim_enable_t anim = obs->config.config ? *(lv_anim_enable_t*)obs->config.config : LV_ANIM_ON;
-                        const lv_obj_class_t * cls = lv_obj_get_class(obs->widget);
-
-                        if (cls == &lv_bar_class) {
-                            lv_bar_set_value(obs->widget, val, anim);
-                        } else if (cls == &lv_slider_class) {
-                            lv_slider_set_value(obs->widget, val, anim);
-                        } else if (cls == &lv_arc_class) {
-                            // lv_arc_set_value doesn't have an anim parameter
-                            lv_arc_set_value(obs->widget, val);
-                        } else {
-                            print_warning("Widget of type <unknown class> does not support 'value' observation.");
-                        }
-                        break;
-                    }
-                    case OBSERVER_TYPE_VISIBLE:
-                    case OBSERVER_TYPE_CHECKED:
-                    case OBSERVER_TYPE_DISABLED: {
-                        bool target_state;
-                        if (obs->config.config_len > 0) { // Map-based
-                            bool found = false;
-                            binding_map_entry_t* map = (binding_map_entry_t*)obs->config.config;
-                            for (size_t k = 0; k < obs->config.config_len; k++) {
-                                if (values_equal(&map[k].key, &new_value)) {
-                                    target_state = map[k].value.b_val;
-                                    found = true;
-                                    break;
-                                }
-                            }
-                            if (!found && obs->config.default_value) {
-                                target_state = *(bool*)obs->config.default_value;
-                            } else if (!found) {
-                                continue;
-                            }
-                        } else { // Direct bool mapping
-                            bool is_truthy = (new_value.type == BINDING_TYPE_BOOL && new_value.as.b_val) ||
-                                             (new_value.type == BINDING_TYPE_FLOAT && new_value.as.f_val != 0.0f) ||
-                                             (new_value.type == BINDING_TYPE_STRING && new_value.as.s_val && *new_value.as.s_val != '\0');
-                            bool is_inverse = (obs->config.config == NULL) || !(*(bool*)obs->config.config);
-                            target_state = is_inverse ? !is_truthy : is_inverse;
-                        }
-
-                        lv_obj_flag_t flag = 0;
-                        lv_state_t state = 0;
-                        if (obs->config.update_type == OBSERVER_TYPE_VISIBLE) flag = LV_OBJ_FLAG_HIDDEN;
-                        if (obs->config.update_type == OBSERVER_TYPE_DISABLED) state = LV_STATE_DISABLED;
-                        if (obs->config.update_type == OBSERVER_TYPE_CHECKED) state = LV_STATE_CHECKED;
-
-                        if (flag) { // Visibility is an obj_flag
-                             if (target_state) lv_obj_clear_flag(obs->widget, flag);
-                             else lv_obj_add_flag(obs->widget, flag);
-                        } else if (state) { // Others are states
-                             if (target_state) lv_obj_add_state(obs->widget, state);
-                             else lv_obj_clear_state(obs->widget, state);
-                        }
-                        break;
-                    }
-                    case OBSERVER_TYPE_STYLE: {
-                        // ** THE FIX **: Do not apply custom styles if the object is disabled,
-                        // as LVGL's disabled style should take precedence.
-                        if (lv_obj_has_state(obs->widget, LV_STATE_DISABLED)) {
-                            // If we previously applied a style, remove it now that the widget is disabled.
-                            if(obs->config.last_applied_style) {
-                                lv_obj_remove_style(obs->widget, obs->config.last_applied_style, 0);
-                                obs->config.last_applied_style = NULL;
-                            }
-                            continue;
-                        }
-
-                        lv_style_t* style_to_apply = NULL;
-                        binding_map_entry_t* map = (binding_map_entry_t*)obs->config.config;
-                        bool found = false;
-                        for (size_t k = 0; k < obs->config.config_len; k++) {
-                             if (values_equal(&map[k].key, &new_value)) {
-                                style_to_apply = (lv_style_t*)map[k].value.p_val;
-                                found = true;
-                                break;
-                            }
-                        }
-                        if (!found && obs->config.default_value) {
-                            style_to_apply = (lv_style_t*)obs->config.default_value;
-                        }
-
-                        if (obs->config.last_applied_style != style_to_apply) {
-                            if (obs->config.last_applied_style) {
-                                lv_obj_remove_style(obs->widget, obs->config.last_applied_style, 0);
-                            }
-                            if (style_to_apply) {
-                                lv_obj_add_style(obs->widget, style_to_apply, 0);
-                            }
-                            obs->config.last_applied_style = style_to_apply;
-                        }
-                        break;
-                    }
+    int i = find_state_slot(state_name, hash_state_name(state_name));
+    if (i < 0) {
+        DEBUG_LOG(LOG_MODULE_DATABINDING, "No observers found for state: '%s'", state_name);
+        return;
+    }
+    data_binding_notify_state_changed_h(i, new_value);
+}
+
+// Copies a string into a reusable, growable buffer and returns the copy.
+static const char* copy_to_buffer(char** buf, size_t* cap, const char* str) {
+    size_t len = strlen(str) + 1;
+    if (len > *cap) {
+        char* new_buf = realloc(*buf, len);
+        if (!new_buf) render_abort("Failed to allocate state string buffer");
+        *buf = new_buf;
+        *cap = len;
+    }
+    memcpy(*buf, str, len);
+    return *buf;
+}
+
+// Returns the number of decimal digits a float shown through this observer can
+// resolve, or -1 if the observer needs the exact value (map keys, truthiness).
+static int observer_float_digits(const ObserverConfig* cfg) {
+    if (cfg->update_type == OBSERVER_TYPE_VALUE) return 0; // Widgets take int32_t
+    if (cfg->update_type != OBSERVER_TYPE_TEXT || cfg->config_len > 0) return -1;
+
+    const TextFormatter* f = cfg->config;
+    switch (f->kind) {
+        case TEXT_FORMAT_LITERAL: return 0;
+        case TEXT_FORMAT_INT:     return 0;
+        case TEXT_FORMAT_FIXED:   return f->precision;
+        default:
+            if (f->kind == TEXT_FORMAT_GENERIC && f->conversion && strchr("diuxX", f->conversion)) return 0;
+            return -1; // %e/%g scale with magnitude, %s shows the value as-is
+    }
+}
+
+// True if `new_value` would render the same as the last applied value.
+static bool state_value_unchanged(const StateEntry* entry, const binding_value_t* new_value) {
+    if (entry->always_apply || !entry->has_last_value || entry->last_value.type != new_value->type) return false;
+    switch (new_value->type) {
+        case BINDING_TYPE_NULL:   return true;
+        case BINDING_TYPE_BOOL:   return entry->last_value.as.b_val == new_value->as.b_val;
+        case BINDING_TYPE_STRING:
+            if (!entry->last_value.as.s_val || !new_value->as.s_val) return entry->last_value.as.s_val == new_value->as.s_val;
+            return strcmp(entry->last_value.as.s_val, new_value->as.s_val) == 0;
+        case BINDING_TYPE_INT:    return entry->last_value.as.i_val == new_value->as.i_val;
+        case BINDING_TYPE_INT64:  return entry->last_value.as.i64_val == new_value->as.i64_val;
+        case BINDING_TYPE_FLOAT:
+        case BINDING_TYPE_DOUBLE: {
+            double a = value_as_double(&entry->last_value), b = value_as_double(new_value);
+            if (entry->float_exact || entry->float_digits < 0) return a == b;
+            // Quantize to the finest precision any observer displays.
+            double scale = pow10_table[entry->float_digits];
+            if (!(fabs(a * scale) < 9.0e18 && fabs(b * scale) < 9.0e18)) return a == b; // Also catches NaN
+            return llround(a * scale) == llround(b * scale);
+        }
+        default: return false;
+    }
+}
+
+static void remember_state_value(StateEntry* entry, binding_value_t value) {
+    if (value.type == BINDING_TYPE_STRING && value.as.s_val) {
+        value.as.s_val = copy_to_buffer(&entry->last_string, &entry->last_string_cap, value.as.s_val);
+    }
+    entry->last_value = value;
+    entry->has_last_value = true;
+}
+
+// Records the latest value of a state to be applied by flush_pending_states().
+// String values are copied, since the caller's buffer may not outlive the batch.
+static void defer_state_value(data_binding_state_handle_t handle, binding_value_t new_value) {
+    StateEntry* entry = &states[handle];
+    if (new_value.type == BINDING_TYPE_STRING && new_value.as.s_val) {
+        new_value.as.s_val = copy_to_buffer(&entry->pending_string, &entry->pending_string_cap, new_value.as.s_val);
+    }
+    entry->pending_value = new_value;
+
+    if (!entry->is_pending) {
+        entry->is_pending = true;
+        entry->next_pending = -1;
+        if (pending_tail >= 0) states[pending_tail].next_pending = handle;
+        else pending_head = handle;
+        pending_tail = handle;
+    }
+}
+
+static void flush_pending_states(void) {
+    // Detach the list first: observers run here may notify again.
+    int32_t handle = pending_head;
+    pending_head = pending_tail = -1;
+    // Derived states are evaluated once all inputs of the batch are in.
+    derived_hold++;
+
+    while (handle >= 0) {
+        StateEntry* entry = &states[handle];
+        int32_t next = entry->next_pending;
+        binding_value_t value = entry->pending_value;
+        // Hold on to the string while it is being applied, in case the state is
+        // deferred again from inside an observer.
+        char* held_string = entry->pending_string;
+        size_t held_cap = entry->pending_string_cap;
+        entry->pending_string = NULL;
+        entry->pending_string_cap = 0;
+        entry->is_pending = false;
+
+        apply_state_value(handle, value);
+
+        entry = &states[handle]; // The table may have grown meanwhile.
+        if (!entry->pending_string) {
+            entry->pending_string = held_string;
+            entry->pending_string_cap = held_cap;
+        } else {
+            free(held_string);
+        }
+        handle = next;
+    }
+
+    derived_hold--;
+    run_derived_updates();
+}
+
+static void frame_flush_timer_cb(lv_timer_t* timer) {
+    (void)timer;
+    if (batch_depth == 0) flush_pending_states();
+}
+
+void data_binding_notify_state_changed_h(data_binding_state_handle_t handle, binding_value_t new_value) {
+    if (handle < 0 || (uint32_t)handle >= state_count) {
+        DEBUG_LOG(LOG_MODULE_DATABINDING, "Notification for invalid state handle %d ignored.", (int)handle);
+        return;
+    }
+    if (states[handle].derived_expr >= 0) {
+        print_warning("State '%s' is derived and cannot be notified.", states[handle].state_name);
+        return;
+    }
+    if (stats_enabled) states[handle].stat_notifies++;
+    if (batch_depth > 0 || frame_flush_timer) {
+        defer_state_value(handle, new_value);
+        return;
+    }
+    apply_state_value(handle, new_value);
+    run_derived_updates();
+}
+
+void data_binding_notify_int_h(data_binding_state_handle_t handle, int32_t value) {
+    data_binding_notify_state_changed_h(handle, (binding_value_t){ .type = BINDING_TYPE_INT, .as.i_val = value });
+}
+
+void data_binding_notify_int64_h(data_binding_state_handle_t handle, int64_t value) {
+    data_binding_notify_state_changed_h(handle, (binding_value_t){ .type = BINDING_TYPE_INT64, .as.i64_val = value });
+}
+
+void data_binding_notify_double_h(data_binding_state_handle_t handle, double value) {
+    data_binding_notify_state_changed_h(handle, (binding_value_t){ .type = BINDING_TYPE_DOUBLE, .as.d_val = value });
+}
+
+void data_binding_begin_batch(void) {
+    batch_depth++;
+}
+
+void data_binding_end_batch(void) {
+    if (batch_depth == 0) {
+        print_warning("data_binding_end_batch() called without a matching begin.");
+        return;
+    }
+    // In frame-flush mode the timer applies the values on the next refresh.
+    if (--batch_depth == 0 && !frame_flush_timer) {
+        flush_pending_states();
+    }
+}
+
+void data_binding_set_frame_flush(bool enable) {
+    if (enable && !frame_flush_timer) {
+        frame_flush_timer = lv_timer_create(frame_flush_timer_cb, LV_DEF_REFR_PERIOD, NULL);
+    } else if (!enable && frame_flush_timer) {
+        lv_timer_delete(frame_flush_timer);
+        frame_flush_timer = NULL;
+        if (batch_depth == 0) flush_pending_states();
+    }
+}
+
+void data_binding_flush(void) {
+    flush_pending_states();
+}
+
+// --- Derived States ---
+
+// Operand count of each operation, or -1 for the n-ary ones, which take `arg`
+// operands (`arg` pairs for BINDING_OP_CASE).
+static const int8_t expr_op_arity[] = {
+    [BINDING_OP_CONST] = 0, [BINDING_OP_INPUT] = 0,
+    [BINDING_OP_ADD] = -1,  [BINDING_OP_SUB] = 2,  [BINDING_OP_MUL] = -1, [BINDING_OP_DIV] = 2,
+    [BINDING_OP_CLAMP] = 3, [BINDING_OP_SIN] = 1,  [BINDING_OP_COS] = 1,
+    [BINDING_OP_EQ] = 2,    [BINDING_OP_NE] = 2,   [BINDING_OP_GT] = 2,   [BINDING_OP_LT] = 2,
+    [BINDING_OP_GE] = 2,    [BINDING_OP_LE] = 2,
+    [BINDING_OP_AND] = -1,  [BINDING_OP_OR] = -1,  [BINDING_OP_NOT] = 1,  [BINDING_OP_CASE] = -1,
+};
+
+static uint32_t expr_operand_count(const binding_expr_instr_t* ins) {
+    int8_t arity = expr_op_arity[ins->op];
+    if (arity >= 0) return (uint32_t)arity;
+    return ins->op == BINDING_OP_CASE ? 2u * ins->arg : ins->arg;
+}
+
+// Checks a program before it is accepted, so that evaluation needs no bounds checks.
+static bool validate_expr(const binding_expr_instr_t* code, uint32_t code_len, uint32_t const_count, uint32_t input_count) {
+    uint32_t depth = 0;
+    for (uint32_t pc = 0; pc < code_len; pc++) {
+        const binding_expr_instr_t* ins = &code[pc];
+        if (ins->op > BINDING_OP_CASE) return false;
+        if (ins->op == BINDING_OP_CONST && ins->arg >= const_count) return false;
+        if (ins->op == BINDING_OP_INPUT && ins->arg >= input_count) return false;
+        if (expr_op_arity[ins->op] < 0 && ins->arg == 0) return false;
+        uint32_t operands = expr_operand_count(ins);
+        if (operands > depth) return false;
+        depth = depth - operands + 1;
+        if (depth > DATA_BINDING_EXPR_STACK_SIZE) return false;
+    }
+    return depth == 1;
+}
+
+static binding_value_t int_result(int64_t value) {
+    if (value >= INT32_MIN && value <= INT32_MAX) return (binding_value_t){ .type = BINDING_TYPE_INT, .as.i_val = (int32_t)value };
+    return (binding_value_t){ .type = BINDING_TYPE_INT64, .as.i64_val = value };
+}
+
+static binding_value_t double_result(double value) {
+    return (binding_value_t){ .type = BINDING_TYPE_DOUBLE, .as.d_val = value };
+}
+
+static binding_value_t bool_result(bool value) {
+    return (binding_value_t){ .type = BINDING_TYPE_BOOL, .as.b_val = value };
+}
+
+static bool is_true(const binding_value_t* value) {
+    return value->type == BINDING_TYPE_BOOL && value->as.b_val;
+}
+
+// Folds ADD, SUB, MUL or DIV over the operands. Null if one is not a number.
+// Integer arithmetic wraps instead of overflowing.
+static binding_value_t eval_arithmetic(uint8_t op, const binding_value_t* args, uint32_t n) {
+    bool integers = true;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!is_numeric_type(args[i].type)) return (binding_value_t){ .type = BINDING_TYPE_NULL };
+        if (!is_integer_type(args[i].type)) integers = false;
+    }
+    if (integers) {
+        uint64_t acc = (uint64_t)value_as_int64(&args[0]);
+        for (uint32_t i = 1; i < n; i++) {
+            int64_t v = value_as_int64(&args[i]);
+            switch (op) {
+                case BINDING_OP_ADD: acc += (uint64_t)v; break;
+                case BINDING_OP_SUB: acc -= (uint64_t)v; break;
+                case BINDING_OP_MUL: acc *= (uint64_t)v; break;
+                default: // BINDING_OP_DIV; -1 is handled apart since INT64_MIN / -1 overflows
+                    if (v == 0) acc = 0;
+                    else if (v == -1) acc = 0 - acc;
+                    else acc = (uint64_t)((int64_t)acc / v);
+                    break;
+            }
+        }
+        return int_result((int64_t)acc);
+    }
+    double acc = value_as_double(&args[0]);
+    for (uint32_t i = 1; i < n; i++) {
+        double v = value_as_double(&args[i]);
+        switch (op) {
+            case BINDING_OP_ADD: acc += v; break;
+            case BINDING_OP_SUB: acc -= v; break;
+            case BINDING_OP_MUL: acc *= v; break;
+            default:             acc = v != 0.0 ? acc / v : 0.0; break;
+        }
+    }
+    return double_result(acc);
+}
+
+// Orders two numbers: negative, zero or positive. Integers compare exactly.
+static int compare_numbers(const binding_value_t* a, const binding_value_t* b) {
+    if (is_integer_type(a->type) && is_integer_type(b->type)) {
+        int64_t x = value_as_int64(a), y = value_as_int64(b);
+        return (x > y) - (x < y);
+    }
+    double x = value_as_double(a), y = value_as_double(b);
+    return (x > y) - (x < y);
+}
+
+// Same as compare_numbers(), but floats within DERIVED_FLOAT_EPSILON are equal.
+static int compare_numbers_approx(const binding_value_t* a, const binding_value_t* b) {
+    if (is_integer_type(a->type) && is_integer_type(b->type)) return compare_numbers(a, b);
+    double d = value_as_double(a) - value_as_double(b);
+    return (d > DERIVED_FLOAT_EPSILON) - (d < -DERIVED_FLOAT_EPSILON);
+}
+
+static bool expr_values_equal(const binding_value_t* a, const binding_value_t* b) {
+    if (is_numeric_type(a->type) && is_numeric_type(b->type)) return compare_numbers_approx(a, b) == 0;
+    if (a->type != b->type) return false;
+    switch (a->type) {
+        case BINDING_TYPE_BOOL:   return a->as.b_val == b->as.b_val;
+        case BINDING_TYPE_STRING:
+            if (!a->as.s_val || !b->as.s_val) return a->as.s_val == b->as.s_val;
+            return strcmp(a->as.s_val, b->as.s_val) == 0;
+        default:                  return true; // Both null
+    }
+}
+
+// Exact equality, for deciding whether an expression input has changed.
+static bool values_identical(const binding_value_t* a, const binding_value_t* b) {
+    if (a->type != b->type) return false;
+    switch (a->type) {
+        case BINDING_TYPE_BOOL:   return a->as.b_val == b->as.b_val;
+        case BINDING_TYPE_INT:    return a->as.i_val == b->as.i_val;
+        case BINDING_TYPE_INT64:  return a->as.i64_val == b->as.i64_val;
+        case BINDING_TYPE_FLOAT:  return a->as.f_val == b->as.f_val;
+        case BINDING_TYPE_DOUBLE: return a->as.d_val == b->as.d_val;
+        case BINDING_TYPE_STRING:
+            if (!a->as.s_val || !b->as.s_val) return a->as.s_val == b->as.s_val;
+            return strcmp(a->as.s_val, b->as.s_val) == 0;
+        default:                  return true;
+    }
+}
+
+// Runs a validated program. String results point into the constants or into an
+// input's value, and are copied when applied.
+static binding_value_t eval_derived_expr(const DerivedExpr* expr) {
+    binding_value_t stack[DATA_BINDING_EXPR_STACK_SIZE];
+    uint32_t sp = 0;
+    for (uint32_t pc = 0; pc < expr->code_len; pc++) {
+        const binding_expr_instr_t* ins = &expr->code[pc];
+        if (ins->op == BINDING_OP_CONST) {
+            stack[sp++] = expr->consts[ins->arg];
+            continue;
+        }
+        if (ins->op == BINDING_OP_INPUT) {
+            const StateEntry* input = &states[expr->inputs[ins->arg]];
+            stack[sp++] = input->has_value ? input->value : (binding_value_t){ .type = BINDING_TYPE_NULL };
+            continue;
+        }
+
+        uint32_t n = expr_operand_count(ins);
+        sp -= n;
+        const binding_value_t* args = &stack[sp];
+        binding_value_t result = { .type = BINDING_TYPE_NULL };
+        switch (ins->op) {
+            case BINDING_OP_ADD:
+            case BINDING_OP_SUB:
+            case BINDING_OP_MUL:
+            case BINDING_OP_DIV:
+                result = eval_arithmetic(ins->op, args, n);
+                break;
+            case BINDING_OP_CLAMP:
+                if (!is_numeric_type(args[0].type) || !is_numeric_type(args[1].type) || !is_numeric_type(args[2].type)) break;
+                if (compare_numbers(&args[0], &args[1]) < 0) result = args[1];
+                else if (compare_numbers(&args[0], &args[2]) > 0) result = args[2];
+                else result = args[0];
+                break;
+            case BINDING_OP_SIN:
+            case BINDING_OP_COS:
+                if (!is_numeric_type(args[0].type)) break;
+                result = double_result(ins->op == BINDING_OP_SIN ? sin(value_as_double(&args[0])) : cos(value_as_double(&args[0])));
+                break;
+            case BINDING_OP_EQ:
+                result = bool_result(expr_values_equal(&args[0], &args[1]));
+                break;
+            case BINDING_OP_NE:
+                result = bool_result(!expr_values_equal(&args[0], &args[1]));
+                break;
+            case BINDING_OP_GT:
+            case BINDING_OP_LT:
+            case BINDING_OP_GE:
+            case BINDING_OP_LE: {
+                if (!is_numeric_type(args[0].type) || !is_numeric_type(args[1].type)) break;
+                int cmp = compare_numbers_approx(&args[0], &args[1]);
+                bool r = ins->op == BINDING_OP_GT ? cmp > 0 : ins->op == BINDING_OP_LT ? cmp < 0 :
+                         ins->op == BINDING_OP_GE ? cmp >= 0 : cmp <= 0;
+                result = bool_result(r);
+                break;
+            }
+            // Conditions must be bools, as in UI-Sim: anything else counts as false.
+            case BINDING_OP_AND:
+            case BINDING_OP_OR: {
+                bool want = ins->op == BINDING_OP_OR;
+                bool r = !want;
+                for (uint32_t i = 0; i < n; i++) {
+                    if (is_true(&args[i]) == want) { r = want; break; }
                 }
+                result = bool_result(r);
+                break;
             }
-            return;
+            case BINDING_OP_NOT:
+                if (args[0].type == BINDING_TYPE_BOOL) result = bool_result(!args[0].as.b_val);
+                break;
+            case BINDING_OP_CASE:
+                for (uint32_t i = 0; i < n; i += 2) {
+                    if (is_true(&args[i])) { result = args[i + 1]; break; }
+                }
+                break;
         }
+        stack[sp++] = result;
     }
-    DEBUG_LOG(LOG_MODULE_DATABINDING, "No observers found for state: '%s'", state_name);
+    return stack[0];
 }
 
+static void mark_derived_dirty(int32_t index) {
+    DerivedExpr* expr = &derived_exprs[index];
+    if (expr->is_dirty) return;
+    expr->is_dirty = true;
+    derived_dirty[derived_dirty_count++] = index;
+}
 
-void data_binding_add_observer(const char* state_name, lv_obj_t* widget,
-                               observer_update_type_t update_type,
-                               const void* config, size_t config_len, const void* default_value)
-{
-    if (!state_name || !widget) return;
+static void update_expr_input(data_binding_state_handle_t handle, const binding_value_t* new_value) {
+    StateEntry* entry = &states[handle];
+    if (entry->has_value && values_identical(&entry->value, new_value)) return;
+    binding_value_t value = *new_value;
+    if (value.type == BINDING_TYPE_STRING && value.as.s_val) {
+        value.as.s_val = copy_to_buffer(&entry->value_string, &entry->value_string_cap, value.as.s_val);
+    }
+    entry->value = value;
+    entry->has_value = true;
+    for (int32_t e = entry->first_dependent; e >= 0; e = derived_edges[e].next) {
+        mark_derived_dirty(derived_edges[e].expr);
+    }
+}
+
+// Evaluates the dirty expressions, lowest level first and in registration order
+// within a level. Applying a result may dirty expressions further downstream,
+// which the loop then picks up.
+static void run_derived_updates(void) {
+    if (derived_hold > 0) return;
+    derived_hold++;
+    while (derived_dirty_count > 0) {
+        uint32_t next = 0;
+        for (uint32_t i = 1; i < derived_dirty_count; i++) {
+            uint32_t level = derived_exprs[derived_dirty[i]].level, best = derived_exprs[derived_dirty[next]].level;
+            if (level < best || (level == best && derived_dirty[i] < derived_dirty[next])) next = i;
+        }
+        int32_t index = derived_dirty[next];
+        derived_dirty[next] = derived_dirty[--derived_dirty_count];
+        derived_exprs[index].is_dirty = false;
+
+        binding_value_t result = eval_derived_expr(&derived_exprs[index]);
+        if (result.type == BINDING_TYPE_NULL) continue;
+        data_binding_state_handle_t handle = derived_exprs[index].state;
+        if (stats_enabled) states[handle].stat_notifies++;
+        apply_state_value(handle, result);
+    }
+    derived_hold--;
+}
+
+// True if one of the inputs is `handle` itself, or is computed (directly or
+// through other derived states) from it.
+static bool derived_creates_cycle(data_binding_state_handle_t handle, const data_binding_state_handle_t* inputs, uint32_t input_count) {
+    // Mark every state downstream of `handle`; each is pushed at most once.
+    data_binding_state_handle_t* stack = malloc(state_count * sizeof(data_binding_state_handle_t));
+    if (!stack) render_abort("Failed to allocate derived state cycle check");
+    uint32_t mark = ++derived_visit_mark;
+    uint32_t sp = 0;
+    states[handle].visit_mark = mark;
+    stack[sp++] = handle;
+    while (sp > 0) {
+        data_binding_state_handle_t h = stack[--sp];
+        for (int32_t e = states[h].first_dependent; e >= 0; e = derived_edges[e].next) {
+            data_binding_state_handle_t downstream = derived_exprs[derived_edges[e].expr].state;
+            if (states[downstream].visit_mark == mark) continue;
+            states[downstream].visit_mark = mark;
+            stack[sp++] = downstream;
+        }
+    }
+    free(stack);
+
+    for (uint32_t i = 0; i < input_count; i++) {
+        if (states[inputs[i]].visit_mark == mark) return true;
+    }
+    return false;
+}
+
+// Keeps the expressions downstream of `handle` above `level`.
+static void raise_dependent_levels(data_binding_state_handle_t handle, uint32_t level) {
+    for (int32_t e = states[handle].first_dependent; e >= 0; e = derived_edges[e].next) {
+        DerivedExpr* expr = &derived_exprs[derived_edges[e].expr];
+        if (expr->level > level) continue;
+        expr->level = level + 1;
+        raise_dependent_levels(expr->state, expr->level);
+    }
+}
+
+static void reserve_derived_slots(uint32_t extra_edges) {
+    if (derived_count == derived_capacity) {
+        uint32_t new_capacity = derived_capacity ? derived_capacity * 2 : 8;
+        DerivedExpr* new_exprs = realloc(derived_exprs, new_capacity * sizeof(DerivedExpr));
+        if (new_exprs) derived_exprs = new_exprs;
+        int32_t* new_dirty = realloc(derived_dirty, new_capacity * sizeof(int32_t));
+        if (new_dirty) derived_dirty = new_dirty;
+        if (!new_exprs || !new_dirty) render_abort("Failed to grow derived states");
+        derived_capacity = new_capacity;
+    }
+    if (derived_edge_count + extra_edges > derived_edge_capacity) {
+        uint32_t new_capacity = derived_edge_capacity ? derived_edge_capacity * 2 : 16;
+        while (new_capacity < derived_edge_count + extra_edges) new_capacity *= 2;
+        DerivedEdge* new_edges = realloc(derived_edges, new_capacity * sizeof(DerivedEdge));
+        if (!new_edges) render_abort("Failed to grow derived state edges");
+        derived_edges = new_edges;
+        derived_edge_capacity = new_capacity;
+    }
+}
+
+data_binding_state_handle_t data_binding_add_derived_state(const char* state_name,
+                                                           const binding_expr_instr_t* code, uint32_t code_len,
+                                                           const binding_value_t* consts, uint32_t const_count,
+                                                           const data_binding_state_handle_t* inputs, uint32_t input_count) {
+    if (!state_name || !code || (const_count > 0 && !consts) || (input_count > 0 && !inputs)) return DATA_BINDING_INVALID_STATE;
+    for (uint32_t i = 0; i < input_count; i++) {
+        if (inputs[i] < 0 || (uint32_t)inputs[i] >= state_count) {
+            print_warning("Derived state '%s' has an invalid input handle %d.", state_name, (int)inputs[i]);
+            return DATA_BINDING_INVALID_STATE;
+        }
+    }
+    if (!validate_expr(code, code_len, const_count, input_count)) {
+        print_warning("Derived state '%s' has a malformed expression.", state_name);
+        return DATA_BINDING_INVALID_STATE;
+    }
+    data_binding_state_handle_t handle = resolve_state_slot(state_name);
+    if (states[handle].derived_expr >= 0) {
+        print_warning("State '%s' is already derived.", state_name);
+        return DATA_BINDING_INVALID_STATE;
+    }
+    if (derived_creates_cycle(handle, inputs, input_count)) {
+        print_warning("Derived state '%s' would depend on itself.", state_name);
+        return DATA_BINDING_INVALID_STATE;
+    }
+
+    reserve_derived_slots(input_count);
+    int32_t index = (int32_t)derived_count++;
+    DerivedExpr* expr = &derived_exprs[index];
+    expr->state = handle;
+    binding_expr_instr_t* code_copy = arena_alloc(code_len * sizeof(binding_expr_instr_t));
+    memcpy(code_copy, code, code_len * sizeof(binding_expr_instr_t));
+    expr->code = code_copy;
+    expr->code_len = code_len;
+    binding_value_t* const_copy = NULL;
+    if (const_count > 0) {
+        const_copy = arena_alloc(const_count * sizeof(binding_value_t));
+        for (uint32_t i = 0; i < const_count; i++) {
+            const_copy[i] = consts[i];
+            if (consts[i].type == BINDING_TYPE_STRING && consts[i].as.s_val) const_copy[i].as.s_val = arena_strdup(consts[i].as.s_val);
+        }
+    }
+    expr->consts = const_copy;
+    data_binding_state_handle_t* input_copy = NULL;
+    if (input_count > 0) {
+        input_copy = arena_alloc(input_count * sizeof(data_binding_state_handle_t));
+        memcpy(input_copy, inputs, input_count * sizeof(data_binding_state_handle_t));
+    }
+    expr->inputs = input_copy;
+    expr->is_dirty = false;
+
+    expr->level = 1;
+    for (uint32_t i = 0; i < input_count; i++) {
+        StateEntry* input = &states[inputs[i]];
+        if (input->derived_expr >= 0 && derived_exprs[input->derived_expr].level >= expr->level) {
+            expr->level = derived_exprs[input->derived_expr].level + 1;
+        }
+        // Until now nothing tracked the input's value; start from the last one applied.
+        if (input->first_dependent < 0 && input->has_last_value) {
+            binding_value_t last = input->last_value;
+            update_expr_input(inputs[i], &last);
+        }
+        derived_edges[derived_edge_count] = (DerivedEdge){ .expr = index, .next = input->first_dependent };
+        input->first_dependent = (int32_t)derived_edge_count++;
+    }
+    states[handle].derived_expr = index;
+    raise_dependent_levels(handle, expr->level);
+
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Added derived state '%s' (%u instructions, level %u).",
+              state_name, (unsigned)code_len, (unsigned)expr->level);
+    mark_derived_dirty(index);
+    run_derived_updates();
+    return handle;
+}
+
+// --- Statistics ---
+
+static void stats_invalidate_area_cb(lv_event_t* e) {
+    const lv_area_t* area = lv_event_get_param(e);
+    if (stats_active_state < 0 || (uint32_t)stats_active_state >= state_count || !area) return;
+    states[stats_active_state].stat_invalidated_area += lv_area_get_size(area);
+}
+
+void data_binding_set_stats_enabled(bool enable) {
+    if (enable == stats_enabled) return;
+    lv_display_t* display = lv_display_get_default();
+    if (enable) {
+        if (display) lv_display_add_event_cb(display, stats_invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+        else print_warning("No default display; binding stats will not include invalidated area.");
+    } else if (display) {
+        lv_display_remove_event_cb_with_user_data(display, stats_invalidate_area_cb, NULL);
+    }
+    stats_enabled = enable;
+}
+
+uint32_t data_binding_get_stats(data_binding_state_stats_t* stats, uint32_t max_count) {
+    for (uint32_t i = 0; stats && i < state_count && i < max_count; i++) {
+        const StateEntry* entry = &states[i];
+        stats[i] = (data_binding_state_stats_t){
+            .state_name = entry->state_name,
+            .notify_count = entry->stat_notifies,
+            .apply_count = entry->stat_applies,
+            .widget_updates = entry->stat_widget_updates,
+            .invalidated_area = entry->stat_invalidated_area,
+        };
+    }
+    return state_count;
+}
+
+void data_binding_reset_stats(void) {
+    for (uint32_t i = 0; i < state_count; i++) {
+        states[i].stat_notifies = 0;
+        states[i].stat_applies = 0;
+        states[i].stat_widget_updates = 0;
+        states[i].stat_invalidated_area = 0;
+    }
+}
+
+bool data_binding_post_state(data_binding_state_handle_t handle, binding_value_t value) {
+    size_t pos = atomic_load_explicit(&post_enqueue_pos, memory_order_relaxed);
+    PostSlot* slot;
+    for (;;) {
+        size_t index = pos & POST_QUEUE_MASK;
+        slot = &post_slots[index];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire) + index;
+        intptr_t diff = (intptr_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&post_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) { // The consumer has not freed this slot yet
+            atomic_fetch_add_explicit(&post_dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&post_enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->handle = handle;
+    slot->value = value;
+    if (value.type == BINDING_TYPE_STRING && value.as.s_val) {
+        size_t len = 0;
+        while (len < DATA_BINDING_POST_STRING_MAX - 1 && value.as.s_val[len]) len++;
+        memcpy(slot->string, value.as.s_val, len);
+        slot->string[len] = '\0';
+        slot->value.as.s_val = slot->string;
+    }
+    atomic_store_explicit(&slot->sequence, pos + 1 - (pos & POST_QUEUE_MASK), memory_order_release);
+    return true;
+}
+
+// Takes every posted value off the queue. Values are applied inside a batch,
+// which keeps only the last value of each state, unless `apply` is false.
+static void drain_post_queue(bool apply) {
+    if (apply) data_binding_begin_batch();
+    for (;;) {
+        size_t pos = post_dequeue_pos;
+        size_t index = pos & POST_QUEUE_MASK;
+        PostSlot* slot = &post_slots[index];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire) + index;
+        if (seq != pos + 1) break; // Empty, or the producer is still writing
+
+        // notify_state_changed_h() copies a deferred string, so the slot can be reused right after.
+        if (apply) data_binding_notify_state_changed_h(slot->handle, slot->value);
+        post_dequeue_pos = pos + 1;
+        atomic_store_explicit(&slot->sequence, pos + DATA_BINDING_POST_QUEUE_SIZE - index, memory_order_release);
+    }
+    if (apply) data_binding_end_batch();
+
+    unsigned dropped = atomic_exchange_explicit(&post_dropped, 0, memory_order_relaxed);
+    if (dropped > 0 && apply) {
+        print_warning("%u posted state values were dropped because the post queue was full. Raise DATA_BINDING_POST_QUEUE_SIZE.", dropped);
+    }
+}
+
+static void post_drain_timer_cb(lv_timer_t* timer) {
+    (void)timer;
+    drain_post_queue(true);
+}
 
-    int state_idx = -1;
-    for (uint32_t i = 0; i < state_observer_count; ++i) {
-        if (strcmp(state_observers[i].state_name, state_name) == 0) {
-            state_idx = i;
+void data_binding_set_post_drain(bool enable) {
+    if (enable && !post_drain_timer) {
+        post_drain_timer = lv_timer_create(post_drain_timer_cb, LV_DEF_REFR_PERIOD, NULL);
+    } else if (!enable && post_drain_timer) {
+        lv_timer_delete(post_drain_timer);
+        post_drain_timer = NULL;
+        drain_post_queue(true);
+    }
+}
+
+void data_binding_drain_posted(void) {
+    drain_post_queue(true);
+}
+
+// Evaluates the group's config for the new value once, then applies the result
+// to each member widget. Widgets already showing the result are left alone, so
+// they are not invalidated. Returns the number of widgets changed.
+static uint32_t apply_group_value(int32_t g, const binding_value_t* new_value, const char* state_name) {
+    const ObserverConfig* cfg = &observer_groups[g].config;
+    uint32_t updates = 0;
+    observer_update_type_t update_type = cfg->update_type;
+
+    // The result is kept in locals, since widget updates may add observers and
+    // move the group table.
+    char text[128];
+    data_binding_value_setter_t setter = NULL;
+    lv_anim_enable_t anim = LV_ANIM_OFF;
+    int32_t int_value = 0;
+    bool target_state = false;
+    lv_style_t* style_to_apply = NULL;
+
+    switch (update_type) {
+        case OBSERVER_TYPE_TEXT: {
+            TextOut out = { text, sizeof(text), 0 };
+            format_text(&out, (const TextFormatter*)cfg->config, new_value);
+            break;
+        }
+        case OBSERVER_TYPE_VALUE: {
+            if (!is_numeric_type(new_value->type)) {
+                print_warning("State '%s' sent non-numeric data to a 'value' binding.", state_name);
+                return 0;
+            }
+            const ValueObserverConfig* vcfg = cfg->config;
+            if (!vcfg->setter) return 0;
+            setter = vcfg->setter;
+            anim = vcfg->anim;
+            int_value = value_to_int32(new_value);
+            break;
+        }
+        case OBSERVER_TYPE_VISIBLE:
+        case OBSERVER_TYPE_CHECKED:
+        case OBSERVER_TYPE_DISABLED: {
+            if (cfg->config_len > 0) { // Map-based
+                const binding_map_entry_t* entry = observer_map_lookup(cfg->config, new_value);
+                if (entry) {
+                    target_state = entry->value.b_val;
+                } else if (cfg->default_value) {
+                    target_state = *(bool*)cfg->default_value;
+                } else {
+                    return 0;
+                }
+            } else { // Direct bool mapping
+                bool is_truthy = value_is_truthy(new_value);
+                bool is_inverse = (cfg->config == NULL) || !(*(bool*)cfg->config);
+                target_state = is_inverse ? !is_truthy : is_truthy;
+            }
+            break;
+        }
+        case OBSERVER_TYPE_STYLE: {
+            const binding_map_entry_t* entry = cfg->config_len > 0 ? observer_map_lookup(cfg->config, new_value) : NULL;
+            style_to_apply = entry ? (lv_style_t*)entry->value.p_val : (lv_style_t*)cfg->default_value;
             break;
         }
     }
 
-    if (state_idx == -1) {
-        if (state_observer_count >= MAX_STATES) {
-            print_warning("Max number of observed states (%d) reached.", MAX_STATES, state_name);
-            return;
+    for (int32_t o = observer_groups[g].first_member; o >= 0; o = observer_next[o]) {
+        lv_obj_t* widget = observer_widgets[o];
+
+        switch (update_type) {
+            case OBSERVER_TYPE_TEXT: {
+                // Setting identical text would still invalidate the label.
+                const char* current = lv_label_get_text(widget);
+                if (current && strcmp(current, text) == 0) break;
+                lv_label_set_text(widget, text);
+                updates++;
+                break;
+            }
+            case OBSERVER_TYPE_VALUE:
+                setter(widget, int_value, anim);
+                updates++;
+                break;
+            case OBSERVER_TYPE_VISIBLE:
+                // Changing the hidden flag invalidates the widget even if it was already set.
+                if (lv_obj_has_flag(widget, LV_OBJ_FLAG_HIDDEN) != target_state) break;
+                if (target_state) lv_obj_clear_flag(widget, LV_OBJ_FLAG_HIDDEN);
+                else lv_obj_add_flag(widget, LV_OBJ_FLAG_HIDDEN);
+                updates++;
+                break;
+            case OBSERVER_TYPE_CHECKED:
+            case OBSERVER_TYPE_DISABLED: {
+                lv_state_t state = update_type == OBSERVER_TYPE_CHECKED ? LV_STATE_CHECKED : LV_STATE_DISABLED;
+                if (lv_obj_has_state(widget, state) == target_state) break;
+                if (target_state) lv_obj_add_state(widget, state);
+                else lv_obj_clear_state(widget, state);
+                updates++;
+                break;
+            }
+            case OBSERVER_TYPE_STYLE: {
+                // ** THE FIX **: Do not apply custom styles if the object is disabled,
+                // as LVGL's disabled style should take precedence.
+                lv_style_t* last_style = observer_last_style[o];
+                if (lv_obj_has_state(widget, LV_STATE_DISABLED)) {
+                    // If we previously applied a style, remove it now that the widget is disabled.
+                    if (last_style) {
+                        lv_obj_remove_style(widget, last_style, 0);
+                        observer_last_style[o] = NULL;
+                        updates++;
+                    }
+                    break;
+                }
+                if (last_style != style_to_apply) {
+                    if (last_style) {
+                        lv_obj_remove_style(widget, last_style, 0);
+                    }
+                    if (style_to_apply) {
+                        lv_obj_add_style(widget, style_to_apply, 0);
+                    }
+                    observer_last_style[o] = style_to_apply;
+                    updates++;
+                }
+                break;
+            }
         }
-        state_idx = state_observer_count++;
-        state_observers[state_idx].state_name = strdup(state_name);
-        state_observers[state_idx].observer_count = 0;
     }
+    return updates;
+}
 
-    StateObserverMapping* mapping = &state_observers[state_idx];
-    if (mapping->observer_count >= MAX_OBSERVERS_PER_STATE) {
-        print_warning("Max observers for state '%s' reached.", state_name);
+// Updates every observer of the state right away, unless the value would not
+// change what they show.
+static void apply_state_value(data_binding_state_handle_t handle, binding_value_t new_value) {
+    // Expressions see every exact change, even one the observers would not show.
+    if (states[handle].first_dependent >= 0) update_expr_input(handle, &new_value);
+    if (state_value_unchanged(&states[handle], &new_value)) {
+        DEBUG_LOG(LOG_MODULE_DATABINDING, "State '%s' unchanged, skipping observers.", states[handle].state_name);
         return;
     }
+    remember_state_value(&states[handle], new_value);
+    const char* state_name = states[handle].state_name;
+
+    // Observers may notify other states; restore the outer one afterwards.
+    data_binding_state_handle_t outer_state = stats_active_state;
+    stats_active_state = handle;
+    uint32_t updates = 0;
+    for (int32_t g = states[handle].first_group; g >= 0; g = observer_groups[g].next_group) {
+        if (observer_groups[g].live_members == 0) continue;
+        updates += apply_group_value(g, &new_value, state_name);
+    }
+    stats_active_state = outer_state;
+
+    if (stats_enabled) {
+        states[handle].stat_applies++;
+        states[handle].stat_widget_updates += updates;
+    }
+}
+
+// True if both optional bools are absent, or both present and equal.
+static bool optional_bools_equal(const bool* a, const bool* b) {
+    if (!a || !b) return a == b;
+    return *a == *b;
+}
+
+static bool map_keys_equal(const binding_value_t* a, const binding_value_t* b) {
+    if (a->type != b->type) return false;
+    switch (a->type) {
+        case BINDING_TYPE_BOOL:   return a->as.b_val == b->as.b_val;
+        case BINDING_TYPE_FLOAT:  return a->as.f_val == b->as.f_val;
+        case BINDING_TYPE_INT:    return a->as.i_val == b->as.i_val;
+        case BINDING_TYPE_INT64:  return a->as.i64_val == b->as.i64_val;
+        case BINDING_TYPE_DOUBLE: return a->as.d_val == b->as.d_val;
+        case BINDING_TYPE_STRING:
+            if (!a->as.s_val || !b->as.s_val) return a->as.s_val == b->as.s_val;
+            return strcmp(a->as.s_val, b->as.s_val) == 0;
+        default: return true;
+    }
+}
 
-    Observer* obs = &mapping->observers[mapping->observer_count++];
-    obs->widget = widget;
-    obs->config.update_type = update_type;
-    obs->config.config_len = config_len;
-    obs->config.last_applied_style = NULL;
+// True if a group's compiled config was built from the same arguments as a new
+// observer's. `setter` is the setter resolved for the new widget (VALUE only).
+static bool observer_config_matches(const ObserverConfig* cfg, observer_update_type_t update_type,
+                                    const void* config, size_t config_len, const void* default_value,
+                                    data_binding_value_setter_t setter)
+{
+    if (cfg->update_type != update_type || cfg->config_len != config_len) return false;
 
-    // Deep copy config data
     if (update_type == OBSERVER_TYPE_VALUE) {
-        if (config) {
-            lv_anim_enable_t* anim = malloc(sizeof(lv_anim_enable_t));
-            if (!anim) render_abort("Failed to allocate observer anim config");
-            *anim = *(const lv_anim_enable_t*)config;
-            obs->config.config = anim;
-        } else {
-            obs->config.config = NULL; // Use default
-        }
-    } else if (config_len > 0) { // It's a map
-        size_t map_size = config_len * sizeof(binding_map_entry_t);
-        binding_map_entry_t* copied_map = malloc(map_size);
-        if (!copied_map) render_abort("Failed to allocate observer map config");
-        memcpy(copied_map, config, map_size);
+        const ValueObserverConfig* vcfg = cfg->config;
+        lv_anim_enable_t anim = config ? *(const lv_anim_enable_t*)config : LV_ANIM_ON;
+        return vcfg->setter == setter && vcfg->anim == anim;
+    }
+
+    if (update_type == OBSERVER_TYPE_STYLE) {
+        if (cfg->default_value != default_value) return false;
+    } else if (!optional_bools_equal(cfg->default_value, default_value)) {
+        return false;
+    }
+
+    if (config_len > 0) { // Map
+        const ObserverMap* map = cfg->config;
+        const binding_map_entry_t* entries = config;
         for (size_t i = 0; i < config_len; i++) {
-            if (copied_map[i].key.type == BINDING_TYPE_STRING) {
-                copied_map[i].key.as.s_val = strdup(copied_map[i].key.as.s_val);
+            if (!map_keys_equal(&map->entries[i].key, &entries[i].key)) return false;
+            if (update_type == OBSERVER_TYPE_STYLE) {
+                if (map->entries[i].value.p_val != entries[i].value.p_val) return false;
+            } else if (map->entries[i].value.b_val != entries[i].value.b_val) {
+                return false;
             }
         }
-        obs->config.config = copied_map;
-    } else { // It's a format string or a bool*
-        if (update_type == OBSERVER_TYPE_TEXT) {
-            obs->config.config = config ? strdup((const char*)config) : NULL;
-        } else if (config) {
-            bool* b = malloc(sizeof(bool));
-            if (!b) render_abort("Failed to allocate observer bool config");
-            *b = *(const bool*)config;
-            obs->config.config = b;
-        } else {
-            obs->config.config = NULL;
+        return true;
+    }
+
+    if (update_type == OBSERVER_TYPE_TEXT) {
+        const TextFormatter* f = cfg->config;
+        return strcmp(f->format, config ? (const char*)config : "%s") == 0;
+    }
+    return optional_bools_equal(cfg->config, config);
+}
+
+// Attaches an observer to an existing state slot. With `borrow`, map and
+// format string configs are referenced in place instead of copied.
+static void add_state_observer(int state_idx, lv_obj_t* widget,
+                               observer_update_type_t update_type,
+                               const void* config, size_t config_len, const void* default_value,
+                               bool borrow)
+{
+    const char* state_name = states[state_idx].state_name;
+    data_binding_value_setter_t setter = NULL;
+    if (update_type == OBSERVER_TYPE_VALUE) {
+        setter = resolve_value_setter(widget);
+        if (!setter) {
+            print_warning("Widget %p observing '%s' has no value setter for its class. Register one with data_binding_register_value_setter().",
+                          (void*)widget, state_name);
         }
     }
 
-    if (default_value) {
-         if (update_type == OBSERVER_TYPE_STYLE) {
-            obs->config.default_value = (void*)default_value;
-         } else {
-            bool* b = malloc(sizeof(bool));
-            if (!b) render_abort("Failed to allocate observer default value");
-            *b = *(const bool*)default_value;
-            obs->config.default_value = b;
-         }
-    } else {
-        obs->config.default_value = NULL;
+    // Share the config of an existing group when the arguments are identical.
+    // Groups whose widgets are all gone keep their config and can be reused.
+    int32_t g = -1;
+    for (int32_t i = states[state_idx].first_group; i >= 0; i = observer_groups[i].next_group) {
+        if (observer_config_matches(&observer_groups[i].config, update_type, config, config_len, default_value, setter)) {
+            g = i;
+            break;
+        }
+    }
+
+    if (g < 0) {
+        g = alloc_observer_group(state_idx);
+        ObserverConfig* cfg = &observer_groups[g].config;
+        cfg->update_type = update_type;
+        cfg->config_len = config_len;
+
+        // Compile config data into the arena, copying it unless borrowed. Bools
+        // point at shared constants.
+        if (update_type == OBSERVER_TYPE_VALUE) {
+            ValueObserverConfig* vcfg = arena_alloc(sizeof(ValueObserverConfig));
+            vcfg->anim = config ? *(const lv_anim_enable_t*)config : LV_ANIM_ON;
+            vcfg->setter = setter;
+            cfg->config = vcfg;
+        } else if (config_len > 0) { // It's a map
+            cfg->config = compile_observer_map((const binding_map_entry_t*)config, config_len, borrow);
+        } else { // It's a format string or a bool*
+            if (update_type == OBSERVER_TYPE_TEXT) {
+                cfg->config = compile_text_formatter(config ? (const char*)config : "%s", borrow || !config);
+            } else if (config) {
+                cfg->config = (void*)&bool_constants[*(const bool*)config ? 1 : 0];
+            } else {
+                cfg->config = NULL;
+            }
+        }
+
+        if (default_value) {
+             if (update_type == OBSERVER_TYPE_STYLE) {
+                cfg->default_value = (void*)default_value;
+             } else {
+                cfg->default_value = (void*)&bool_constants[*(const bool*)default_value ? 1 : 0];
+             }
+        } else {
+            cfg->default_value = NULL;
+        }
+
+        StateEntry* entry = &states[state_idx];
+        int digits = observer_float_digits(cfg);
+        if (digits < 0) entry->float_exact = true;
+        else if (digits > entry->float_digits) entry->float_digits = (int8_t)digits;
     }
 
-    lv_obj_add_event_cb(widget, free_observer_config_cb, LV_EVENT_DELETE, &obs->config);
+    int32_t index = alloc_observer_slot();
+    observer_widgets[index] = widget;
+    observer_group[index] = g;
+    ObserverGroup* group = &observer_groups[g];
+    observer_prev[index] = group->last_member;
+    if (group->last_member >= 0) observer_next[group->last_member] = index;
+    else group->first_member = index;
+    group->last_member = index;
+    group->live_members++;
+
+    // The new widget has not seen any value yet, so the next notification must go through.
+    StateEntry* entry = &states[state_idx];
+    entry->has_last_value = false;
+    if (observer_may_go_stale(widget, update_type)) entry->always_apply = true;
+
+    // The pool may be reallocated, so the callback gets the index rather than a pointer.
+    lv_obj_add_event_cb(widget, observer_widget_deleted_cb, LV_EVENT_DELETE, (void*)(intptr_t)index);
+
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Added observer for state '%s' to widget %p (group %d).", state_name, (void*)widget, (int)g);
+}
+
+void data_binding_add_observer(const char* state_name, lv_obj_t* widget,
+                               observer_update_type_t update_type,
+                               const void* config, size_t config_len, const void* default_value)
+{
+    if (!state_name || !widget) return;
+    add_state_observer(resolve_state_slot(state_name), widget, update_type, config, config_len, default_value, false);
+}
+
+void data_binding_register_table(const binding_observer_desc_t* table, size_t n, lv_obj_t** widgets) {
+    if (!table || !widgets) return;
+
+    // Size the pools for the whole table up front; every observer may need its own group.
+    reserve_observer_slots((uint32_t)n);
+    reserve_observer_groups((uint32_t)n);
 
-    DEBUG_LOG(LOG_MODULE_DATABINDING, "Added observer for state '%s' to widget %p.", state_name, (void*)widget);
+    for (size_t i = 0; i < n; i++) {
+        const binding_observer_desc_t* desc = &table[i];
+        if (desc->state < 0 || (uint32_t)desc->state >= state_count) {
+            print_warning("Observer table entry %u refers to unknown state handle %d.", (unsigned)i, (int)desc->state);
+            continue;
+        }
+        lv_obj_t* widget = widgets[desc->widget];
+        if (!widget) continue;
+        add_state_observer(desc->state, widget, desc->update_type, desc->config, desc->config_len, desc->default_value,
+                           (desc->flags & BINDING_OBSERVER_BORROWED) != 0);
+    }
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Registered observer table with %u entries.", (unsigned)n);
 }
 
-void data_binding_add_action(lv_obj_t* widget, const char* action_name, action_type_t type, const binding_value_t* cycle_values, uint32_t cycle_value_count, const void* config_data) {
+void data_binding_add_action(lv_obj_t* widget, const char* action_name, action_type_t type,
+                             const binding_value_t* cycle_values, uint32_t cycle_value_count, const void* config_data,
+                             uint32_t throttle_ms, uint32_t debounce_ms) {
     if (!widget || !action_name) return;
+    if (type == ACTION_TYPE_CYCLE && (!cycle_values || cycle_value_count == 0)) return;
 
-    ActionUserData* user_data = calloc(1, sizeof(ActionUserData));
-    if (!user_data) render_abort("Failed to allocate action user data");
+    value_getter_t getter = NULL;
+    if (type == ACTION_TYPE_VALUE) {
+        getter = resolve_value_getter(widget);
+        if (!getter) {
+            print_warning("Widget %p with 'value' action '%s' has no value getter for its class.", (void*)widget, action_name);
+            return;
+        }
+    }
 
+    // The user data lives in the binding arena and is released by data_binding_init().
+    ActionUserData* user_data = arena_calloc(1, sizeof(ActionUserData));
     user_data->type = type;
-    user_data->action_name = strdup(action_name);
-    if (!user_data->action_name) {
-        free(user_data);
-        render_abort("Failed to duplicate action name");
-        return;
-    }
+    user_data->action_id = data_binding_resolve_action(action_name);
+    user_data->action_name = actions[user_data->action_id].name;
+    user_data->widget = widget;
 
     lv_event_cb_t cb = generic_action_event_cb;
     lv_event_code_t code = LV_EVENT_CLICKED;
 
     if (type == ACTION_TYPE_TOGGLE) {
         code = LV_EVENT_VALUE_CHANGED;
+    } else if (type == ACTION_TYPE_VALUE) {
+        code = LV_EVENT_VALUE_CHANGED;
+        user_data->getter = getter;
     } else if (type == ACTION_TYPE_CYCLE) {
-        if (!cycle_values || cycle_value_count == 0) {
-            free((void*)user_data->action_name);
-            free(user_data);
-            return;
-        }
-
-        binding_value_t* copied_values = malloc(cycle_value_count * sizeof(binding_value_t));
-        if (!copied_values) render_abort("Failed to allocate memory for cycle action values.");
-
+        binding_value_t* copied_values = arena_alloc(cycle_value_count * sizeof(binding_value_t));
         for (uint32_t i = 0; i < cycle_value_count; i++) {
             copied_values[i] = cycle_values[i];
             if (cycle_values[i].type == BINDING_TYPE_STRING && cycle_values[i].as.s_val) {
-                copied_values[i].as.s_val = strdup(cycle_values[i].as.s_val);
-                if (!copied_values[i].as.s_val) render_abort("Failed to duplicate string in cycle action values.");
+                copied_values[i].as.s_val = arena_strdup(cycle_values[i].as.s_val);
             }
         }
 
@@ -385,70 +2450,129 @@ void data_binding_add_action(lv_obj_t* widget, const char* action_name, action_t
         user_data->value_count = cycle_value_count;
     } else if (type == ACTION_TYPE_NUMERIC_DIALOG) {
         if (config_data) {
-            NumericDialogConfig* new_config = calloc(1, sizeof(NumericDialogConfig));
-            if (!new_config) render_abort("Failed to allocate numeric dialog config.");
+            NumericDialogConfig* new_config = arena_calloc(1, sizeof(NumericDialogConfig));
             const NumericDialogConfig* src_config = (const NumericDialogConfig*)config_data;
             new_config->min_val = src_config->min_val;
             new_config->max_val = src_config->max_val;
             new_config->initial_val = src_config->initial_val;
-            if (src_config->format_str) new_config->format_str = strdup(src_config->format_str);
-            if (src_config->text) new_config->text = strdup(src_config->text);
+            if (src_config->format_str) new_config->format_str = arena_strdup(src_config->format_str);
+            if (src_config->text) new_config->text = arena_strdup(src_config->text);
             user_data->config_data = new_config;
         }
     }
 
+    // The dialog only dispatches on OK, so there is nothing to rate limit.
+    if ((throttle_ms || debounce_ms) && type != ACTION_TYPE_NUMERIC_DIALOG) {
+        user_data->throttle_ms = throttle_ms;
+        user_data->debounce_ms = debounce_ms;
+        user_data->timer = lv_timer_create(action_rate_timer_cb, debounce_ms ? debounce_ms : throttle_ms, user_data);
+        lv_timer_pause(user_data->timer);
+        user_data->next_limited = rate_limited_actions;
+        rate_limited_actions = user_data;
+        lv_obj_add_event_cb(widget, action_widget_deleted_cb, LV_EVENT_DELETE, user_data);
+    }
+
     lv_obj_add_event_cb(widget, cb, code, user_data);
     if (code == LV_EVENT_CLICKED) {
       lv_obj_add_flag(widget, LV_OBJ_FLAG_CLICKABLE);
     }
-    lv_obj_add_event_cb(widget, free_action_user_data_cb, LV_EVENT_DELETE, user_data);
-    DEBUG_LOG(LOG_MODULE_DATABINDING, "Added action '%s' (type %d) to widget %p.", action_name, type, (void*)widget);
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Added action '%s' (type %d, throttle %ums, debounce %ums) to widget %p.",
+              action_name, type, (unsigned)throttle_ms, (unsigned)debounce_ms, (void*)widget);
 }
 
+// --- Action Rate Limiting ---
 
-// --- Event Callback Implementations ---
+static void dispatch_limited_action(ActionUserData* action, binding_value_t value) {
+    action->has_dispatched = true;
+    action->last_dispatch_tick = lv_tick_get();
+    dispatch_action(action->action_id, action->action_name, value);
+}
 
-static void free_observer_config_cb(lv_event_t* e) {
-    ObserverConfig* config = lv_event_get_user_data(e);
-    if (config) {
-        if (config->update_type != OBSERVER_TYPE_VALUE && config->config_len > 0) { // It's a map
-            binding_map_entry_t* map = config->config;
-            for (size_t i = 0; i < config->config_len; i++) {
-                if (map[i].key.type == BINDING_TYPE_STRING) {
-                    free((void*)map[i].key.as.s_val);
-                }
-            }
+static void arm_action_timer(ActionUserData* action, uint32_t period) {
+    lv_timer_set_period(action->timer, period);
+    lv_timer_reset(action->timer);
+    lv_timer_resume(action->timer);
+    action->timer_armed = true;
+}
+
+// Throttling sends the first value of a burst right away and then at most one
+// value per window, ending with the latest. Debouncing holds the latest value
+// until the widget has been quiet for debounce_ms; with both set, values still
+// go out once per throttle window while the widget keeps changing.
+static void rate_limit_action(ActionUserData* action, binding_value_t value) {
+    uint32_t elapsed = action->has_dispatched ? lv_tick_elaps(action->last_dispatch_tick) : UINT32_MAX;
+    if (action->throttle_ms && elapsed >= action->throttle_ms) {
+        action->has_pending = false;
+        if (action->timer_armed) {
+            lv_timer_pause(action->timer);
+            action->timer_armed = false;
         }
-        free(config->config);
-        free(config->default_value);
-        config->config = NULL;
-        config->default_value = NULL;
-        DEBUG_LOG(LOG_MODULE_DATABINDING, "Freed observer config for widget %p.", (void*)lv_event_get_target(e));
+        dispatch_limited_action(action, value);
+        return;
+    }
+
+    action->pending_value = value;
+    action->has_pending = true;
+    if (action->debounce_ms) {
+        arm_action_timer(action, action->debounce_ms);
+    } else if (!action->timer_armed) {
+        arm_action_timer(action, action->throttle_ms - elapsed);
     }
 }
 
-static void free_action_user_data_cb(lv_event_t* e) {
-    ActionUserData* user_data = lv_event_get_user_data(e);
-    if (user_data) {
-        free((void*)user_data->action_name);
-        if (user_data->type == ACTION_TYPE_CYCLE && user_data->values) {
-            for (uint32_t i = 0; i < user_data->value_count; i++) {
-                if (user_data->values[i].type == BINDING_TYPE_STRING && user_data->values[i].as.s_val) {
-                    free((void*)user_data->values[i].as.s_val);
-                }
-            }
-            free(user_data->values);
-        } else if (user_data->type == ACTION_TYPE_NUMERIC_DIALOG && user_data->config_data) {
-            NumericDialogConfig* cfg = (NumericDialogConfig*)user_data->config_data;
-            free(cfg->format_str);
-            free(cfg->text);
-            free(cfg);
+static void action_rate_timer_cb(lv_timer_t* timer) {
+    ActionUserData* action = lv_timer_get_user_data(timer);
+    lv_timer_pause(timer);
+    action->timer_armed = false;
+    if (action->has_pending) {
+        action->has_pending = false;
+        dispatch_limited_action(action, action->pending_value);
+    }
+}
+
+static void action_widget_deleted_cb(lv_event_t* e) {
+    ActionUserData* action = lv_event_get_user_data(e);
+    lv_obj_t* widget = lv_event_get_target(e);
+    // Entries that are no longer listed were released, timer included, by
+    // data_binding_init(). A pending value is dropped with the widget.
+    for (ActionUserData** link = &rate_limited_actions; *link; link = &(*link)->next_limited) {
+        if (*link == action && action->widget == widget) {
+            lv_timer_delete(action->timer);
+            *link = action->next_limited;
+            return;
         }
-        DEBUG_LOG(LOG_MODULE_DATABINDING, "Freeing user_data for widget %p.", (void*)lv_event_get_target(e));
-        free(user_data);
     }
 }
 
+
+// --- Event Callback Implementations ---
+
+static void observer_widget_deleted_cb(lv_event_t* e) {
+    intptr_t index = (intptr_t)lv_event_get_user_data(e);
+    lv_obj_t* widget = lv_event_get_target(e);
+    // A mismatch means the pool was reset by data_binding_init() since the
+    // callback was added; there is nothing left to detach then.
+    if (index < 0 || (uint32_t)index >= observer_count || observer_widgets[index] != widget) return;
+
+    ObserverGroup* group = &observer_groups[observer_group[index]];
+    int32_t prev = observer_prev[index];
+    int32_t next = observer_next[index];
+    if (prev >= 0) observer_next[prev] = next;
+    else group->first_member = next;
+    if (next >= 0) observer_prev[next] = prev;
+    else group->last_member = prev;
+    group->live_members--;
+
+    // observer_next[index] is left alone, so a notify loop that is standing on
+    // this entry when the widget goes away still reaches the rest of the group.
+    observer_widgets[index] = NULL;
+    observer_group[index] = -1;
+    observer_last_style[index] = NULL;
+    observer_prev[index] = observer_free_head;
+    observer_free_head = (int32_t)index;
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Detached observer from deleted widget %p.", (void*)widget);
+}
+
 // --- Numeric Dialog Implementation ---
 
 static void update_scale_labels(DialogEventData* data) {
@@ -502,9 +2626,7 @@ static void mb_ok_event_cb(lv_event_t* e) {
     binding_value_t final_value = {.type = BINDING_TYPE_FLOAT, .as.f_val = value};
 
     DEBUG_LOG(LOG_MODULE_DATABINDING, "Numeric dialog OK, dispatching action '%s' with value %f.", data->action_name, final_value.as.f_val);
-    if (app_action_handler) {
-        app_action_handler(data->action_name, final_value, app_user_data);
-    }
+    dispatch_action(data->action_id, data->action_name, final_value);
 
     // This callback handles both OK and Cancel, so we always close.
     lv_msgbox_close(data->msgbox);
@@ -592,6 +2714,7 @@ static void create_and_show_numeric_dialog(ActionUserData* user_data) {
     data->value_label = value_label;
     data->scale_min_label = min_label;
     data->scale_max_label = max_label;
+    data->action_id = user_data->action_id;
     data->action_name = strdup(user_data->action_name);
     data->dialog_config = cfg;
 
@@ -633,12 +2756,19 @@ static void generic_action_event_cb(lv_event_t* e) {
                 user_data->current_index = (user_data->current_index + 1) % user_data->value_count;
             }
             break;
+        case ACTION_TYPE_VALUE:
+            val.type = BINDING_TYPE_FLOAT;
+            val.as.f_val = (float)user_data->getter(lv_event_get_target(e));
+            break;
         case ACTION_TYPE_NUMERIC_DIALOG: // Should not be reached
             break;
     }
 
-    DEBUG_LOG(LOG_MODULE_DATABINDING, "Dispatching action: '%s'", user_data->action_name);
-    if (app_action_handler) {
-        app_action_handler(user_data->action_name, val, app_user_data);
+    if (user_data->timer) {
+        rate_limit_action(user_data, val);
+        return;
     }
+
+    DEBUG_LOG(LOG_MODULE_DATABINDING, "Dispatching action: '%s' (ID %d)", user_data->action_name, (int)user_data->action_id);
+    dispatch_action(user_data->action_id, user_data->action_name, val);
 }
\ No newline at end of file
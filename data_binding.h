@@ -9,13 +9,18 @@
 
 /**
  * @brief Enum for the types of values that can be passed through the binding system.
- * All numeric types are consolidated into BINDING_TYPE_FLOAT.
+ * Values coming from the UI (actions, generated map keys) use BINDING_TYPE_FLOAT for
+ * numbers. The application may publish states with any of the numeric types; integer
+ * values are formatted and applied to widgets without going through floating point.
  */
 typedef enum {
     BINDING_TYPE_NULL,
     BINDING_TYPE_FLOAT,
     BINDING_TYPE_BOOL,
     BINDING_TYPE_STRING,
+    BINDING_TYPE_INT,    // int32_t
+    BINDING_TYPE_INT64,  // int64_t
+    BINDING_TYPE_DOUBLE, // double
 } binding_value_type_t;
 
 /**
@@ -27,6 +32,9 @@ typedef struct {
         float f_val;
         bool b_val;
         const char* s_val; // Assumed to be a persistent string
+        int32_t i_val;
+        int64_t i64_val;
+        double d_val;
     } as;
 } binding_value_t;
 
@@ -38,6 +46,7 @@ typedef enum {
     ACTION_TYPE_TOGGLE,         // Toggles between bool true/false (0/1)
     ACTION_TYPE_CYCLE,          // Cycles through a list of predefined values
     ACTION_TYPE_NUMERIC_DIALOG, // Opens a modal dialog to input a number
+    ACTION_TYPE_VALUE,          // Sends the value of a slider, arc, etc. whenever it changes
 } action_type_t;
 
 /**
@@ -53,6 +62,30 @@ typedef enum {
 } observer_update_type_t;
 
 
+/**
+ * @brief An interned handle for a state, as returned by data_binding_resolve_state().
+ * Handles are dense indices starting at 0 and stay valid until the next data_binding_init().
+ */
+typedef int32_t data_binding_state_handle_t;
+
+#define DATA_BINDING_INVALID_STATE ((data_binding_state_handle_t)-1)
+
+/**
+ * @brief A dense ID for an action name, as returned by data_binding_resolve_action().
+ * IDs start at 0 and stay valid until the next data_binding_init().
+ */
+typedef int32_t data_binding_action_id_t;
+
+#define DATA_BINDING_INVALID_ACTION ((data_binding_action_id_t)-1)
+
+/**
+ * @brief Applies an integer value to a widget for an OBSERVER_TYPE_VALUE binding.
+ * @param widget The observing widget.
+ * @param value The state's value, rounded to the nearest integer.
+ * @param anim The animation setting configured on the observer.
+ */
+typedef void (*data_binding_value_setter_t)(lv_obj_t* widget, int32_t value, lv_anim_enable_t anim);
+
 /**
  * @brief A function pointer for the application's main action handler.
  * This single function will receive all actions triggered by the UI.
@@ -62,11 +95,24 @@ typedef enum {
  */
 typedef void (*data_binding_action_handler_t)(const char* action_name, binding_value_t value, void* user_data);
 
+/**
+ * @brief Same as data_binding_action_handler_t, but receives the action's ID instead of its
+ * name, so the handler can dispatch with a switch over the generated UI_ACTION_* constants.
+ * @param action_id The ID of the action being triggered.
+ * @param value The value associated with the action (if any).
+ * @param user_data The user-provided context pointer registered with the handler.
+ */
+typedef void (*data_binding_action_id_handler_t)(data_binding_action_id_t action_id, binding_value_t value, void* user_data);
+
 
 // --- Public API for the Main Application ---
 
 /**
  * @brief Initializes the data binding system. Must be called once.
+ * Calling it again releases every state, observer and action config created
+ * since the last call in one go. Delete the widgets bound against the previous
+ * UI first (e.g. with lv_obj_clean()), since their action callbacks point into
+ * the released configs.
  */
 void data_binding_init(void);
 
@@ -78,6 +124,27 @@ void data_binding_init(void);
  */
 void data_binding_register_action_handler(data_binding_action_handler_t handler, void* user_data);
 
+/**
+ * @brief Registers an action handler that is called with action IDs instead of names.
+ * It is independent of the name-based handler; when both are registered, both are called.
+ * @param handler A pointer to the function that will process UI actions, or NULL to remove it.
+ * @param user_data A pointer passed to every invocation of the handler.
+ */
+void data_binding_register_action_id_handler(data_binding_action_id_handler_t handler, void* user_data);
+
+/**
+ * @brief Resolves an action name to its ID, registering the name if it is not known yet.
+ * Applications without a generated header can resolve their IDs once, after create_ui().
+ * @param action_name The action name as written in the UI spec.
+ * @return The action's ID, or DATA_BINDING_INVALID_ACTION if action_name is NULL.
+ */
+data_binding_action_id_t data_binding_resolve_action(const char* action_name);
+
+/**
+ * @brief Returns the name of an action ID, or NULL if the ID is not known.
+ */
+const char* data_binding_get_action_name(data_binding_action_id_t action_id);
+
 /**
  * @brief Notifies the UI that a piece of the application's state has changed.
  * The data binding library will find all widgets observing this state and update them.
@@ -86,11 +153,172 @@ void data_binding_register_action_handler(data_binding_action_handler_t handler,
  */
 void data_binding_notify_state_changed(const char* state_name, binding_value_t new_value);
 
+/**
+ * @brief Resolves a state name to its handle, registering the state if it is not known yet.
+ * Resolve once at startup and use data_binding_notify_state_changed_h() for updates
+ * to skip the per-notification name lookup.
+ * @param state_name The unique name of the state variable.
+ * @return The state's handle, or DATA_BINDING_INVALID_STATE if `state_name` is NULL.
+ */
+data_binding_state_handle_t data_binding_resolve_state(const char* state_name);
+
+/**
+ * @brief Same as data_binding_notify_state_changed(), but addresses the state by handle.
+ * Invalid handles are ignored.
+ * @param handle A handle from data_binding_resolve_state() or a generated UI_STATE_* constant.
+ * @param new_value The new value of the state in a binding_value_t.
+ */
+void data_binding_notify_state_changed_h(data_binding_state_handle_t handle, binding_value_t new_value);
+
+/**
+ * @brief Typed shorthands for data_binding_notify_state_changed_h().
+ * Integer states keep an integer-only path through text formatting ("%d", "%.2f", "%s")
+ * and 'value' bindings, so counts beyond float precision are shown exactly.
+ */
+void data_binding_notify_int_h(data_binding_state_handle_t handle, int32_t value);
+void data_binding_notify_int64_h(data_binding_state_handle_t handle, int64_t value);
+void data_binding_notify_double_h(data_binding_state_handle_t handle, double value);
+
+/**
+ * @brief Registers the function used by 'value' observers on widgets of a class.
+ * Bar, slider, arc, spinbox, roller (selected option), dropdown (selected option) and
+ * LED (brightness) are built in. A registered setter overrides a built-in one, and
+ * also applies to classes derived from `cls` that have no setter of their own.
+ * The setter is resolved when the observer is added, so register it before creating the UI.
+ * Registrations are kept across data_binding_init().
+ * @param cls The widget class, e.g. &lv_spinbox_class.
+ * @param setter The function applying the value.
+ */
+void data_binding_register_value_setter(const lv_obj_class_t* cls, data_binding_value_setter_t setter);
+
+/**
+ * @brief Starts a batch of notifications. Batches nest.
+ * Until the outermost data_binding_end_batch(), notifications only record the latest
+ * value per state; each state's observers then run once, with its final value.
+ */
+void data_binding_begin_batch(void);
+
+/**
+ * @brief Ends a batch started with data_binding_begin_batch().
+ * Ending the outermost batch applies all recorded values, unless frame flush is enabled,
+ * in which case they are applied on the next refresh period.
+ */
+void data_binding_end_batch(void);
+
+/**
+ * @brief Enables or disables per-frame flushing.
+ * When enabled, every notification is deferred and an LVGL timer running at the display
+ * refresh period (LV_DEF_REFR_PERIOD) applies the latest value of each changed state
+ * once per period. Use this when the application publishes faster than the display refreshes.
+ * Disabling it applies any pending values immediately.
+ * @param enable true to defer notifications to the frame flush timer.
+ */
+void data_binding_set_frame_flush(bool enable);
+
+/**
+ * @brief Immediately applies all deferred notifications.
+ */
+void data_binding_flush(void);
+
+/**
+ * @brief Binding statistics of one state, see data_binding_get_stats().
+ */
+typedef struct {
+    const char* state_name;
+    uint32_t notify_count;     // Notifications received, including deferred and unchanged ones
+    uint32_t apply_count;      // Times the observers ran (after batching and unchanged-value filtering)
+    uint32_t widget_updates;   // Observer updates that changed a widget
+    uint64_t invalidated_area; // Pixels invalidated on the default display while the observers ran
+} data_binding_state_stats_t;
+
+/**
+ * @brief Enables or disables the collection of per-state binding statistics.
+ * Disabled by default. The setting is kept across data_binding_init(), but the counters
+ * belong to the states and start over with them.
+ * @param enable true to count notifications, widget updates and invalidated area.
+ */
+void data_binding_set_stats_enabled(bool enable);
+
+/**
+ * @brief Copies the statistics of the known states, in handle order.
+ * @param stats Receives up to `max_count` entries. May be NULL to only query the count.
+ * @param max_count The capacity of `stats`.
+ * @return The number of states, which may exceed `max_count`.
+ */
+uint32_t data_binding_get_stats(data_binding_state_stats_t* stats, uint32_t max_count);
+
+/**
+ * @brief Resets the statistics of all states to zero.
+ */
+void data_binding_reset_stats(void);
+
+/**
+ * @brief Capacity of the cross-thread post queue. Must be a power of two.
+ */
+#ifndef DATA_BINDING_POST_QUEUE_SIZE
+#define DATA_BINDING_POST_QUEUE_SIZE 256
+#endif
+
+/**
+ * @brief Longest string value, including the terminator, that data_binding_post_state()
+ * carries. Longer strings are truncated.
+ */
+#ifndef DATA_BINDING_POST_STRING_MAX
+#define DATA_BINDING_POST_STRING_MAX 64
+#endif
+
+/**
+ * @brief Publishes a state value from any thread. Never blocks and never touches LVGL.
+ * The value is queued in a lock-free ring buffer and applied on the LVGL thread by the
+ * drain timer (see data_binding_set_post_drain()) or by data_binding_drain_posted().
+ * When a state is posted several times between drains, only its last value is applied.
+ * Resolve handles with data_binding_resolve_state() on the LVGL thread beforehand.
+ * @param handle The state handle.
+ * @param value The new value. Strings are copied into the queue.
+ * @return false if the queue was full and the value was dropped.
+ */
+bool data_binding_post_state(data_binding_state_handle_t handle, binding_value_t value);
+
+/**
+ * @brief Enables or disables the LVGL timer that drains posted values.
+ * The timer runs at the display refresh period (LV_DEF_REFR_PERIOD). Call from the LVGL thread.
+ * data_binding_init() disables it and discards values still queued.
+ * @param enable true to drain posted values periodically.
+ */
+void data_binding_set_post_drain(bool enable);
+
+/**
+ * @brief Applies all values posted so far. Call from the LVGL thread.
+ */
+void data_binding_drain_posted(void);
+
 
 // --- Internal API for Generated Code ---
 
+/**
+ * @brief Registers a list of states so that state_names[i] gets handle i.
+ * Called first thing by the generated create_ui(), which makes the UI_STATE_*
+ * constants in the generated header valid handles.
+ * @param state_names The state names, in handle order.
+ * @param count The number of names.
+ * @return true if every state received the expected handle. False means some states were
+ *         registered before the call (e.g. data_binding_init() was not called first).
+ */
+bool data_binding_register_states(const char* const* state_names, uint32_t count);
+
+/**
+ * @brief Registers a list of actions so that action_names[i] gets ID i.
+ * Called by the generated create_ui() next to data_binding_register_states(),
+ * which makes the UI_ACTION_* constants in the generated header valid IDs.
+ * @param action_names The action names, in ID order.
+ * @param count The number of names.
+ * @return true if every action received the expected ID.
+ */
+bool data_binding_register_actions(const char* const* action_names, uint32_t count);
+
 // Generic map entry structure used by generated code.
-// Note: The key is a binding_value_t to support string, bool, and numeric (float) keys.
+// Note: The key is a binding_value_t to support string, bool, and numeric keys.
+// Numeric keys match numeric values of any type with the same value.
 typedef struct {
     binding_value_t key;
     // The value's interpretation depends on the observer type.
@@ -120,6 +348,103 @@ void data_binding_add_observer(const char* state_name, lv_obj_t* widget,
                                observer_update_type_t update_type,
                                const void* config, size_t config_len, const void* default_value);
 
+/**
+ * @brief Flag for binding_observer_desc_t: use the config and default value in place.
+ * Map entries (with their string keys) and format strings are then referenced instead of
+ * copied, so they must stay valid until the next data_binding_init(). Meant for the
+ * `static const` tables of generated code, which can stay in flash.
+ */
+#define BINDING_OBSERVER_BORROWED 0x01u
+
+/**
+ * @brief One observer in a table for data_binding_register_table().
+ * The fields mirror the arguments of data_binding_add_observer(), except that the state is
+ * given by handle and the widget by its index in the widget array, so the table itself can
+ * be `static const`.
+ */
+typedef struct {
+    data_binding_state_handle_t state; // A handle registered with data_binding_register_states()
+    uint16_t widget;                   // Index into the `widgets` array
+    observer_update_type_t update_type;
+    const void* config;
+    size_t config_len;
+    const void* default_value;
+    uint32_t flags;                    // BINDING_OBSERVER_* flags
+} binding_observer_desc_t;
+
+/**
+ * @brief Adds all observers of a table in one pass.
+ * Called once at the end of the generated create_ui(), after data_binding_register_states().
+ * The observer pools are grown once for the whole table and no state name is looked up.
+ * @param table The observer descriptors.
+ * @param n The number of descriptors.
+ * @param widgets The widgets referenced by the descriptors. NULL entries are skipped.
+ */
+void data_binding_register_table(const binding_observer_desc_t* table, size_t n, lv_obj_t** widgets);
+
+/**
+ * @brief Operations of a derived-state expression, see data_binding_add_derived_state().
+ * An expression is a postfix program: each instruction pops its operands off a value stack
+ * and pushes its result. Arithmetic on integers stays in integers (division truncates);
+ * if any operand is a float or double, the result is a double.
+ */
+typedef enum {
+    BINDING_OP_CONST,  // Pushes consts[arg]
+    BINDING_OP_INPUT,  // Pushes the current value of inputs[arg]
+    BINDING_OP_ADD,    // Pops `arg` numbers, pushes their sum
+    BINDING_OP_SUB,    // a - b
+    BINDING_OP_MUL,    // Pops `arg` numbers, pushes their product
+    BINDING_OP_DIV,    // a / b, 0 if b is 0
+    BINDING_OP_CLAMP,  // value, min, max
+    BINDING_OP_SIN,
+    BINDING_OP_COS,
+    BINDING_OP_EQ,     // Numbers compare by value, floats within 1e-6; strings by content
+    BINDING_OP_NE,
+    BINDING_OP_GT,     // Null unless both are numbers
+    BINDING_OP_LT,
+    BINDING_OP_GE,
+    BINDING_OP_LE,
+    BINDING_OP_AND,    // Pops `arg` values, pushes true if all are the bool true
+    BINDING_OP_OR,     // Pops `arg` values, pushes true if any is the bool true
+    BINDING_OP_NOT,    // Null unless the value is a bool
+    BINDING_OP_CASE,   // Pops `arg` (condition, value) pairs, pushes the value of the first
+                       // condition that is the bool true, or null if there is none
+} binding_expr_op_t;
+
+typedef struct {
+    uint8_t op;   // A binding_expr_op_t
+    uint16_t arg; // Constant or input index, or operand count for the n-ary operations
+} binding_expr_instr_t;
+
+/**
+ * @brief Maximum stack depth of a derived-state expression.
+ */
+#ifndef DATA_BINDING_EXPR_STACK_SIZE
+#define DATA_BINDING_EXPR_STACK_SIZE 16
+#endif
+
+/**
+ * @brief Defines a state whose value is computed from other states.
+ * The expression is evaluated again whenever one of its inputs changes value, and the result
+ * is applied to the state's observers like a notification. Derived states can be inputs of
+ * other derived states; they are then evaluated in dependency order, so each one runs once per
+ * change, after all of its inputs. A null result (e.g. while an input has no value yet) is not
+ * applied. The program, constants and inputs are copied.
+ * @param state_name The derived state. It can be observed like any other state, but not notified.
+ * @param code The postfix program.
+ * @param code_len The number of instructions.
+ * @param consts The constants referenced by BINDING_OP_CONST. String constants are copied too.
+ * @param const_count The number of constants.
+ * @param inputs The states referenced by BINDING_OP_INPUT.
+ * @param input_count The number of inputs.
+ * @return The derived state's handle, or DATA_BINDING_INVALID_STATE if the program is malformed,
+ *         the state is already derived, or the definition would make the state depend on itself.
+ */
+data_binding_state_handle_t data_binding_add_derived_state(const char* state_name,
+                                                           const binding_expr_instr_t* code, uint32_t code_len,
+                                                           const binding_value_t* consts, uint32_t const_count,
+                                                           const data_binding_state_handle_t* inputs, uint32_t input_count);
+
 /**
  * @brief Attaches an action to a widget.
  * This is called by the generated create_ui() function.
@@ -129,8 +454,14 @@ void data_binding_add_observer(const char* state_name, lv_obj_t* widget,
  * @param cycle_values An array of values for ACTION_TYPE_CYCLE.
  * @param cycle_value_count The number of elements in cycle_values.
  * @param config_data A pointer to arbitrary configuration data for complex actions like dialogs.
+ * @param throttle_ms If non-zero, the action is dispatched at most once per this many milliseconds.
+ *        Values arriving in between are coalesced, and the latest one is sent when the window ends.
+ * @param debounce_ms If non-zero, the latest value is sent once the widget has been quiet for this
+ *        many milliseconds. Combined with throttle_ms, it replaces the end-of-window send.
  */
-void data_binding_add_action(lv_obj_t* widget, const char* action_name, action_type_t type, const binding_value_t* cycle_values, uint32_t cycle_value_count, const void* config_data);
+void data_binding_add_action(lv_obj_t* widget, const char* action_name, action_type_t type,
+                             const binding_value_t* cycle_values, uint32_t cycle_value_count, const void* config_data,
+                             uint32_t throttle_ms, uint32_t debounce_ms);
 
 
 #endif // DATA_BINDING_H
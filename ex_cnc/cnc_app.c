@@ -1,11 +1,104 @@
 #include "cnc_app.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
 // The global instance of our CNC machine's state
 static CNC_State g_cnc_state;
 
+// Handles for the states we publish, resolved once in cnc_app_init().
+static struct {
+    data_binding_state_handle_t position_x;
+    data_binding_state_handle_t position_y;
+    data_binding_state_handle_t position_z;
+    data_binding_state_handle_t spindle_is_on;
+    data_binding_state_handle_t spindle_rpm;
+    data_binding_state_handle_t feedrate_override;
+    data_binding_state_handle_t program_status;
+    data_binding_state_handle_t jog_step;
+} s_states;
+
+static void resolve_state_handles(void) {
+    s_states.position_x = data_binding_resolve_state("position|x");
+    s_states.position_y = data_binding_resolve_state("position|y");
+    s_states.position_z = data_binding_resolve_state("position|z");
+    s_states.spindle_is_on = data_binding_resolve_state("spindle|is_on");
+    s_states.spindle_rpm = data_binding_resolve_state("spindle|rpm");
+    s_states.feedrate_override = data_binding_resolve_state("feedrate|override");
+    s_states.program_status = data_binding_resolve_state("program|status");
+    s_states.jog_step = data_binding_resolve_state("jog|step");
+}
+
+// The actions we handle. Their binding IDs are resolved once in cnc_app_init(),
+// so dispatching a click is an array index rather than a chain of strcmp()s.
+typedef enum {
+    CNC_ACTION_PROGRAM_RUN,
+    CNC_ACTION_PROGRAM_PAUSE,
+    CNC_ACTION_PROGRAM_STOP,
+    CNC_ACTION_SPINDLE_TOGGLE,
+    CNC_ACTION_FEEDRATE_OVERRIDE,
+    CNC_ACTION_POSITION_HOME,
+    CNC_ACTION_JOG_SET_STEP,
+    CNC_ACTION_JOG_X_MINUS,
+    CNC_ACTION_JOG_X_PLUS,
+    CNC_ACTION_JOG_Y_MINUS,
+    CNC_ACTION_JOG_Y_PLUS,
+    CNC_ACTION_JOG_Z_MINUS,
+    CNC_ACTION_JOG_Z_PLUS,
+    CNC_ACTION_COUNT
+} cnc_action_t;
+
+static const char* const cnc_action_names[CNC_ACTION_COUNT] = {
+    [CNC_ACTION_PROGRAM_RUN] = "program|run",
+    [CNC_ACTION_PROGRAM_PAUSE] = "program|pause",
+    [CNC_ACTION_PROGRAM_STOP] = "program|stop",
+    [CNC_ACTION_SPINDLE_TOGGLE] = "spindle|toggle",
+    [CNC_ACTION_FEEDRATE_OVERRIDE] = "feedrate|override",
+    [CNC_ACTION_POSITION_HOME] = "position|home",
+    [CNC_ACTION_JOG_SET_STEP] = "jog|set_step",
+    [CNC_ACTION_JOG_X_MINUS] = "jog|move|x_minus",
+    [CNC_ACTION_JOG_X_PLUS] = "jog|move|x_plus",
+    [CNC_ACTION_JOG_Y_MINUS] = "jog|move|y_minus",
+    [CNC_ACTION_JOG_Y_PLUS] = "jog|move|y_plus",
+    [CNC_ACTION_JOG_Z_MINUS] = "jog|move|z_minus",
+    [CNC_ACTION_JOG_Z_PLUS] = "jog|move|z_plus",
+};
+
+// The cnc_action_t of each binding action ID, or CNC_ACTION_COUNT for IDs we do
+// not handle. Sized from the largest ID resolve_action_ids() got back.
+static uint8_t* s_action_by_id = NULL;
+static uint32_t s_action_by_id_len = 0;
+
+static void resolve_action_ids(void) {
+    data_binding_action_id_t ids[CNC_ACTION_COUNT];
+    uint32_t len = 0;
+    for (int i = 0; i < CNC_ACTION_COUNT; i++) {
+        ids[i] = data_binding_resolve_action(cnc_action_names[i]);
+        if (ids[i] >= 0 && (uint32_t)ids[i] >= len) len = (uint32_t)ids[i] + 1;
+    }
+
+    uint8_t* table = realloc(s_action_by_id, len ? len : 1);
+    if (!table) {
+        fprintf(stderr, "CNC: failed to allocate the action table, actions are ignored.\n");
+        free(s_action_by_id);
+        s_action_by_id = NULL;
+        s_action_by_id_len = 0;
+        return;
+    }
+    memset(table, CNC_ACTION_COUNT, len);
+    for (int i = 0; i < CNC_ACTION_COUNT; i++) {
+        if (ids[i] >= 0) table[ids[i]] = (uint8_t)i;
+    }
+    s_action_by_id = table;
+    s_action_by_id_len = len;
+}
+
+static cnc_action_t find_action(data_binding_action_id_t action_id) {
+    if (action_id < 0 || (uint32_t)action_id >= s_action_by_id_len) return CNC_ACTION_COUNT;
+    return (cnc_action_t)s_action_by_id[action_id];
+}
+
 // Helper to get the string representation of the current program status
 const char* get_status_string() {
     if (g_cnc_state.program_running) {
@@ -18,14 +111,14 @@ const char* get_status_string() {
 }
 
 void cnc_app_notify_all(void) {
-    data_binding_notify_state_changed("position|x", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.x_pos});
-    data_binding_notify_state_changed("position|y", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.y_pos});
-    data_binding_notify_state_changed("position|z", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.z_pos});
-    data_binding_notify_state_changed("spindle|is_on", (binding_value_t){.type = BINDING_TYPE_BOOL, .as.b_val = g_cnc_state.spindle_on});
-    data_binding_notify_state_changed("feedrate|override", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.feed_override});
-    data_binding_notify_state_changed("program|status", (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = get_status_string()});
-    data_binding_notify_state_changed("spindle|rpm", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.spindle_rpm});
-    data_binding_notify_state_changed("jog|step", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.jog_step});
+    data_binding_notify_state_changed_h(s_states.position_x, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.x_pos});
+    data_binding_notify_state_changed_h(s_states.position_y, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.y_pos});
+    data_binding_notify_state_changed_h(s_states.position_z, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.z_pos});
+    data_binding_notify_state_changed_h(s_states.spindle_is_on, (binding_value_t){.type = BINDING_TYPE_BOOL, .as.b_val = g_cnc_state.spindle_on});
+    data_binding_notify_int_h(s_states.feedrate_override, g_cnc_state.feed_override);
+    data_binding_notify_state_changed_h(s_states.program_status, (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = get_status_string()});
+    data_binding_notify_state_changed_h(s_states.spindle_rpm, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.spindle_rpm});
+    data_binding_notify_state_changed_h(s_states.jog_step, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.jog_step});
 }
 
 void cnc_app_init(void) {
@@ -42,95 +135,115 @@ void cnc_app_init(void) {
     g_cnc_state.sim_radius = 0.0f;
 
     // Register our action handler with the data binding system
-    data_binding_register_action_handler(cnc_action_handler, NULL);
+    data_binding_register_action_id_handler(cnc_action_handler, NULL);
+
+    // Must run after the UI is created, so states and actions the UI uses keep their IDs
+    resolve_state_handles();
+    resolve_action_ids();
 
     // Notify initial state to the UI
     cnc_app_notify_all();
 }
 
-void cnc_action_handler(const char* action_name, binding_value_t value, void *user_data) {
-    printf("CNC ACTION: name='%s' | value_type=%d\n", action_name, value.type);
+void cnc_action_handler(data_binding_action_id_t action_id, binding_value_t value, void *user_data) {
+    printf("CNC ACTION: name='%s' | value_type=%d\n", data_binding_get_action_name(action_id), value.type);
     bool position_changed = false;
     bool program_state_changed = false;
     bool spindle_state_changed = false;
 
-    if (strcmp(action_name, "program|run") == 0) {
-        if (!g_cnc_state.program_running) {
-            g_cnc_state.program_running = true;
-            g_cnc_state.spindle_on = true;
+    switch (find_action(action_id)) {
+        case CNC_ACTION_PROGRAM_RUN:
+            if (!g_cnc_state.program_running) {
+                g_cnc_state.program_running = true;
+                g_cnc_state.spindle_on = true;
+                program_state_changed = true;
+                spindle_state_changed = true;
+            }
+            break;
+        case CNC_ACTION_PROGRAM_PAUSE:
+            if (g_cnc_state.program_running) {
+                g_cnc_state.program_running = false;
+                program_state_changed = true;
+            }
+            break;
+        case CNC_ACTION_PROGRAM_STOP:
+            g_cnc_state.program_running = false;
+            g_cnc_state.spindle_on = false;
+            g_cnc_state.sim_angle = 0.0f;
+            g_cnc_state.sim_radius = 0.0f;
+            position_changed = true;
             program_state_changed = true;
             spindle_state_changed = true;
-        }
-    } else if (strcmp(action_name, "program|pause") == 0) {
-        if (g_cnc_state.program_running) {
+            break;
+        case CNC_ACTION_SPINDLE_TOGGLE:
+            g_cnc_state.spindle_on = value.as.b_val;
+            spindle_state_changed = true;
+            program_state_changed = true; // Status string depends on spindle state
+            break;
+        case CNC_ACTION_FEEDRATE_OVERRIDE:
+            g_cnc_state.feed_override = value.as.f_val;
+            data_binding_notify_int_h(s_states.feedrate_override, g_cnc_state.feed_override);
+            break;
+        case CNC_ACTION_POSITION_HOME:
             g_cnc_state.program_running = false;
+            g_cnc_state.spindle_on = false;
+            g_cnc_state.x_pos = 0.0f;
+            g_cnc_state.y_pos = 0.0f;
+            g_cnc_state.z_pos = 25.0f;
+            g_cnc_state.sim_angle = 0.0f;
+            g_cnc_state.sim_radius = 0.0f;
+            position_changed = true;
             program_state_changed = true;
-        }
-    } else if (strcmp(action_name, "program|stop") == 0) {
-        g_cnc_state.program_running = false;
-        g_cnc_state.spindle_on = false;
-        g_cnc_state.sim_angle = 0.0f;
-        g_cnc_state.sim_radius = 0.0f;
-        position_changed = true;
-        program_state_changed = true;
-        spindle_state_changed = true;
-    } else if (strcmp(action_name, "spindle|toggle") == 0) {
-        g_cnc_state.spindle_on = value.as.b_val;
-        spindle_state_changed = true;
-        program_state_changed = true; // Status string depends on spindle state
-    } else if (strcmp(action_name, "feedrate|override") == 0) {
-        g_cnc_state.feed_override = value.as.f_val;
-        data_binding_notify_state_changed("feedrate|override", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.feed_override});
-    } else if (strcmp(action_name, "position|home") == 0) {
-        g_cnc_state.program_running = false;
-        g_cnc_state.spindle_on = false;
-        g_cnc_state.x_pos = 0.0f;
-        g_cnc_state.y_pos = 0.0f;
-        g_cnc_state.z_pos = 25.0f;
-        g_cnc_state.sim_angle = 0.0f;
-        g_cnc_state.sim_radius = 0.0f;
-        position_changed = true;
-        program_state_changed = true;
-        spindle_state_changed = true;
-    } else if (strcmp(action_name, "jog|set_step") == 0) {
-        g_cnc_state.jog_step = value.as.f_val;
-        data_binding_notify_state_changed("jog|step", (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.jog_step});
-    } else if (strcmp(action_name, "jog|move|x_minus") == 0) {
-        if (g_cnc_state.program_running) return;
-        g_cnc_state.x_pos -= g_cnc_state.jog_step;
-        position_changed = true;
-    } else if (strcmp(action_name, "jog|move|x_plus") == 0) {
-        if (g_cnc_state.program_running) return;
-        g_cnc_state.x_pos += g_cnc_state.jog_step;
-        position_changed = true;
-    } else if (strcmp(action_name, "jog|move|y_minus") == 0) {
-        if (g_cnc_state.program_running) return;
-        g_cnc_state.y_pos -= g_cnc_state.jog_step;
-        position_changed = true;
-    } else if (strcmp(action_name, "jog|move|y_plus") == 0) {
-        if (g_cnc_state.program_running) return;
-        g_cnc_state.y_pos += g_cnc_state.jog_step;
-        position_changed = true;
-    } else if (strcmp(action_name, "jog|move|z_minus") == 0) {
-        if (g_cnc_state.program_running) return;
-        g_cnc_state.z_pos -= g_cnc_state.jog_step;
-        position_changed = true;
-    } else if (strcmp(action_name, "jog|move|z_plus") == 0) {
-        if (g_cnc_state.program_running) return;
-        g_cnc_state.z_pos += g_cnc_state.jog_step;
-        position_changed = true;
+            spindle_state_changed = true;
+            break;
+        case CNC_ACTION_JOG_SET_STEP:
+            g_cnc_state.jog_step = value.as.f_val;
+            data_binding_notify_state_changed_h(s_states.jog_step, (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.jog_step});
+            break;
+        case CNC_ACTION_JOG_X_MINUS:
+            if (g_cnc_state.program_running) return;
+            g_cnc_state.x_pos -= g_cnc_state.jog_step;
+            position_changed = true;
+            break;
+        case CNC_ACTION_JOG_X_PLUS:
+            if (g_cnc_state.program_running) return;
+            g_cnc_state.x_pos += g_cnc_state.jog_step;
+            position_changed = true;
+            break;
+        case CNC_ACTION_JOG_Y_MINUS:
+            if (g_cnc_state.program_running) return;
+            g_cnc_state.y_pos -= g_cnc_state.jog_step;
+            position_changed = true;
+            break;
+        case CNC_ACTION_JOG_Y_PLUS:
+            if (g_cnc_state.program_running) return;
+            g_cnc_state.y_pos += g_cnc_state.jog_step;
+            position_changed = true;
+            break;
+        case CNC_ACTION_JOG_Z_MINUS:
+            if (g_cnc_state.program_running) return;
+            g_cnc_state.z_pos -= g_cnc_state.jog_step;
+            position_changed = true;
+            break;
+        case CNC_ACTION_JOG_Z_PLUS:
+            if (g_cnc_state.program_running) return;
+            g_cnc_state.z_pos += g_cnc_state.jog_step;
+            position_changed = true;
+            break;
+        default:
+            break;
     }
 
     if (position_changed) {
-        data_binding_notify_state_changed("position|x", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.x_pos});
-        data_binding_notify_state_changed("position|y", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.y_pos});
-        data_binding_notify_state_changed("position|z", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.z_pos});
+        data_binding_notify_state_changed_h(s_states.position_x, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.x_pos});
+        data_binding_notify_state_changed_h(s_states.position_y, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.y_pos});
+        data_binding_notify_state_changed_h(s_states.position_z, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.z_pos});
     }
     if (program_state_changed) {
-        data_binding_notify_state_changed("program|status", (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = get_status_string()});
+        data_binding_notify_state_changed_h(s_states.program_status, (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = get_status_string()});
     }
     if (spindle_state_changed) {
-        data_binding_notify_state_changed("spindle|is_on", (binding_value_t){.type = BINDING_TYPE_BOOL, .as.b_val = g_cnc_state.spindle_on});
+        data_binding_notify_state_changed_h(s_states.spindle_is_on, (binding_value_t){.type = BINDING_TYPE_BOOL, .as.b_val = g_cnc_state.spindle_on});
     }
 }
 
@@ -159,10 +272,10 @@ void cnc_app_tick(void) {
 
 
     if (needs_notify || (tick_count % 20 == 0)) { // Update less frequently if idle
-        data_binding_notify_state_changed("position|x", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.x_pos});
-        data_binding_notify_state_changed("position|y", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.y_pos});
-        data_binding_notify_state_changed("spindle|rpm", (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.spindle_rpm});
-        data_binding_notify_state_changed("program|status", (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = get_status_string()});
+        data_binding_notify_state_changed_h(s_states.position_x, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.x_pos});
+        data_binding_notify_state_changed_h(s_states.position_y, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.y_pos});
+        data_binding_notify_state_changed_h(s_states.spindle_rpm, (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = g_cnc_state.spindle_rpm});
+        data_binding_notify_state_changed_h(s_states.program_status, (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = get_status_string()});
     }
 
     tick_count++;
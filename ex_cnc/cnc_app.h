@@ -24,8 +24,8 @@ typedef struct {
 // Initializes the CNC application state and registers its action handler.
 void cnc_app_init(void);
 
-// The action handler that receives commands from the UI.
-void cnc_action_handler(const char* action_name, binding_value_t value, void *user_data);
+// The action handler that receives commands from the UI, by action ID.
+void cnc_action_handler(data_binding_action_id_t action_id, binding_value_t value, void *user_data);
 
 // Simulates one tick of the CNC machine; call this from a timer.
 void cnc_app_tick(void);
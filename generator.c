@@ -22,6 +22,8 @@ typedef struct {
     Registry* registry;
     int var_counter;
     bool error_occurred; // Flag to stop processing on error
+    IRDerivedState** derived_states; // Receives the compiled UI-Sim derived states
+    cJSON* sim_state_names;          // Set of the UI-Sim states defined so far
 } GenContext;
 
 // --- Forward Declarations ---
@@ -33,10 +35,13 @@ static void process_and_validate_call(GenContext* ctx, const char* func_name, IR
 static void merge_json_objects(cJSON* dest, const cJSON* source);
 static int count_cjson_array(cJSON* array_json);
 static int count_function_args(const FunctionArg* head);
+static bool parse_action_type_name(const char* name, action_type_t* out_type);
+static uint32_t parse_action_rate_ms(cJSON* act_item, const char* key, const char* action_name);
 static bool types_compatible(const char* expected, const char* actual);
 static cJSON* process_context_keys_recursive(const cJSON* source_json, const cJSON* context);
 static IRRoot* generate_ir_from_string_with_base_path(const char* ui_spec_string, const char* base_path, const ApiSpec* api_spec);
 static void process_ui_spec_array(GenContext* ctx, cJSON* array_json, const char* current_base_path, IRObject** object_list_head, IROperationNode** operation_list_head, const char* parent_c_name, const cJSON* ui_context);
+static void collect_derived_states(GenContext* ctx, cJSON* binding_json);
 
 
 // --- Main Entry Point ---
@@ -57,8 +62,10 @@ IRRoot* generate_ir_from_ui_spec(const cJSON* ui_spec_root, const ApiSpec* api_s
         return NULL;
     }
 
-    GenContext ctx = { .api_spec = api_spec, .registry = registry_create(), .var_counter = 0, .error_occurred = false };
+    GenContext ctx = { .api_spec = api_spec, .registry = registry_create(), .var_counter = 0, .error_occurred = false,
+                       .derived_states = &ir_root->derived_states, .sim_state_names = cJSON_CreateObject() };
     if (!ctx.registry) {
+        cJSON_Delete(ctx.sim_state_names);
         ir_free((IRNode*)ir_root);
         render_abort("Failed to create registry.");
         return NULL;
@@ -103,6 +110,7 @@ IRRoot* generate_ir_from_ui_spec(const cJSON* ui_spec_root, const ApiSpec* api_s
 
 
     registry_free(ctx.registry);
+    cJSON_Delete(ctx.sim_state_names);
 
     if (ctx.error_occurred) {
         ir_free((IRNode*)ir_root);
@@ -154,7 +162,8 @@ static IRRoot* generate_ir_from_string_with_base_path(const char* ui_spec_string
     }
 
     IRRoot* ir_root = ir_new_root();
-    GenContext ctx = { .api_spec = api_spec, .registry = registry_create(), .var_counter = 0, .error_occurred = false };
+    GenContext ctx = { .api_spec = api_spec, .registry = registry_create(), .var_counter = 0, .error_occurred = false,
+                       .derived_states = &ir_root->derived_states, .sim_state_names = cJSON_CreateObject() };
 
     // Pre-pass for components...
     cJSON* item_json = NULL;
@@ -177,6 +186,7 @@ static IRRoot* generate_ir_from_string_with_base_path(const char* ui_spec_string
     process_ui_spec_array(&ctx, ui_spec_json, base_path, &ir_root->root_objects, NULL, root_parent_name, NULL);
 
     registry_free(ctx.registry);
+    cJSON_Delete(ctx.sim_state_names);
     cJSON_Delete(ui_spec_json);
 
     if (ctx.error_occurred) {
@@ -589,10 +599,11 @@ static IRObject* parse_object(GenContext* ctx, cJSON* obj_json, const char* pare
                     action_type_t action_type = ACTION_TYPE_TRIGGER; // Default
                     IRExpr* data_expr = NULL;
 
+                    uint32_t throttle_ms = 0;
+                    uint32_t debounce_ms = 0;
+
                     if (cJSON_IsString(act_item)) {
-                        if (strcmp(act_item->valuestring, "trigger") == 0) action_type = ACTION_TYPE_TRIGGER;
-                        else if (strcmp(act_item->valuestring, "toggle") == 0) action_type = ACTION_TYPE_TOGGLE;
-                        else {
+                        if (!parse_action_type_name(act_item->valuestring, &action_type)) {
                              print_warning("Unknown action type string '%s' for action '%s'.", act_item->valuestring, action_name);
                              continue;
                         }
@@ -600,19 +611,35 @@ static IRObject* parse_object(GenContext* ctx, cJSON* obj_json, const char* pare
                         action_type = ACTION_TYPE_CYCLE;
                         data_expr = unmarshal_value(ctx, act_item, new_scope_context, "binding_value_t*", parent_c_name, ir_obj->c_name, ir_obj);
                     } else if (cJSON_IsObject(act_item)) {
+                        // { type: value, throttle_ms: 50 } or { values: [...], debounce_ms: 200 }
                         cJSON* dialog_config = cJSON_GetObjectItemCaseSensitive(act_item, "numeric_input_dialog");
+                        cJSON* type_item = cJSON_GetObjectItemCaseSensitive(act_item, "type");
+                        cJSON* values_item = cJSON_GetObjectItemCaseSensitive(act_item, "values");
                         if (dialog_config) {
                             action_type = ACTION_TYPE_NUMERIC_DIALOG;
                             data_expr = unmarshal_value(ctx, dialog_config, new_scope_context, "void*", parent_c_name, ir_obj->c_name, ir_obj);
+                        } else if (cJSON_IsArray(values_item)) {
+                            action_type = ACTION_TYPE_CYCLE;
+                            data_expr = unmarshal_value(ctx, values_item, new_scope_context, "binding_value_t*", parent_c_name, ir_obj->c_name, ir_obj);
+                        } else if (cJSON_IsString(type_item)) {
+                            if (!parse_action_type_name(type_item->valuestring, &action_type)) {
+                                print_warning("Unknown action type string '%s' for action '%s'.", type_item->valuestring, action_name);
+                                continue;
+                            }
                         } else {
                             print_warning("Unsupported object-based action config for action '%s'.", action_name);
                             continue;
                         }
+                        throttle_ms = parse_action_rate_ms(act_item, "throttle_ms", action_name);
+                        debounce_ms = parse_action_rate_ms(act_item, "debounce_ms", action_name);
                     } else {
                          print_warning("Unsupported action config for action '%s'.", action_name);
                          continue;
                     }
-                    ir_operation_list_add(&ir_obj->operations, (IRNode*)ir_new_action(action_name, action_type, data_expr));
+                    IRAction* action = ir_new_action(action_name, action_type, data_expr);
+                    action->throttle_ms = throttle_ms;
+                    action->debounce_ms = debounce_ms;
+                    ir_operation_list_add(&ir_obj->operations, (IRNode*)action);
                 }
             }
         } else {
@@ -911,6 +938,25 @@ static int count_function_args(const FunctionArg* head) {
     return count;
 }
 
+static bool parse_action_type_name(const char* name, action_type_t* out_type) {
+    if (strcmp(name, "trigger") == 0) *out_type = ACTION_TYPE_TRIGGER;
+    else if (strcmp(name, "toggle") == 0) *out_type = ACTION_TYPE_TOGGLE;
+    else if (strcmp(name, "value") == 0) *out_type = ACTION_TYPE_VALUE;
+    else return false;
+    return true;
+}
+
+// Reads an optional, non-negative millisecond option of an object-based action.
+static uint32_t parse_action_rate_ms(cJSON* act_item, const char* key, const char* action_name) {
+    cJSON* item = cJSON_GetObjectItemCaseSensitive(act_item, key);
+    if (!item) return 0;
+    if (!cJSON_IsNumber(item) || item->valuedouble < 0 || item->valuedouble > UINT32_MAX) {
+        print_warning("'%s' of action '%s' must be a non-negative number of milliseconds.", key, action_name);
+        return 0;
+    }
+    return (uint32_t)item->valuedouble;
+}
+
 static void merge_json_objects(cJSON* dest, const cJSON* source) {
     if (!cJSON_IsObject(dest) || !cJSON_IsObject(source)) return;
     cJSON* item = NULL;
@@ -1100,6 +1146,7 @@ static void process_ui_spec_array(GenContext* ctx, cJSON* array_json, const char
                 if (strcmp(type_item->valuestring, "component") == 0) continue;
                 if (strcmp(type_item->valuestring, "data-binding") == 0) {
                     if (!ui_sim_process_node(item_json)) ctx->error_occurred = true;
+                    else collect_derived_states(ctx, item_json);
                     continue;
                 }
             }
@@ -1118,3 +1165,183 @@ static void process_ui_spec_array(GenContext* ctx, cJSON* array_json, const char
         }
     }
 }
+
+
+// --- Derived States ---
+// UI-Sim evaluates its `derived_expr` states itself. For the generated code they
+// are compiled to the bytecode of data_binding_add_derived_state(), so that the
+// binding runtime computes them without application code.
+
+typedef struct {
+    const char* name;
+    uint8_t op;
+    uint8_t min_args;
+    uint8_t max_args; // 0 for the n-ary functions
+} DerivedFunction;
+
+static const DerivedFunction derived_functions[] = {
+    { "add", BINDING_OP_ADD, 2, 0 },   { "sub", BINDING_OP_SUB, 2, 2 }, { "mul", BINDING_OP_MUL, 2, 0 },
+    { "div", BINDING_OP_DIV, 2, 2 },   { "sin", BINDING_OP_SIN, 1, 1 }, { "cos", BINDING_OP_COS, 1, 1 },
+    { "clamp", BINDING_OP_CLAMP, 3, 3 },
+    { "==", BINDING_OP_EQ, 2, 2 },     { "!=", BINDING_OP_NE, 2, 2 },   { ">", BINDING_OP_GT, 2, 2 },
+    { "<", BINDING_OP_LT, 2, 2 },      { ">=", BINDING_OP_GE, 2, 2 },   { "<=", BINDING_OP_LE, 2, 2 },
+    { "and", BINDING_OP_AND, 1, 0 },   { "or", BINDING_OP_OR, 1, 0 },   { "not", BINDING_OP_NOT, 1, 1 },
+};
+
+typedef struct {
+    IRDerivedState* ds;
+    const cJSON* known_states;
+    uint32_t depth; // Stack depth after the instructions emitted so far
+} DerivedCompiler;
+
+static bool compile_derived_expr(DerivedCompiler* dc, cJSON* json);
+
+static bool derived_emit(DerivedCompiler* dc, uint8_t op, uint32_t arg, uint32_t operands) {
+    IRDerivedState* ds = dc->ds;
+    if (arg > UINT16_MAX) {
+        print_warning("Derived state '%s': expression is too large.", ds->state_name);
+        return false;
+    }
+    dc->depth = dc->depth - operands + 1;
+    if (dc->depth > DATA_BINDING_EXPR_STACK_SIZE) {
+        print_warning("Derived state '%s': expression is nested too deeply (limit %d).", ds->state_name, DATA_BINDING_EXPR_STACK_SIZE);
+        return false;
+    }
+    binding_expr_instr_t* code = realloc(ds->code, (ds->code_len + 1) * sizeof(binding_expr_instr_t));
+    if (!code) render_abort("Failed to grow derived state code");
+    code[ds->code_len++] = (binding_expr_instr_t){ .op = op, .arg = (uint16_t)arg };
+    ds->code = code;
+    return true;
+}
+
+static bool derived_emit_const(DerivedCompiler* dc, binding_value_t value) {
+    IRDerivedState* ds = dc->ds;
+    binding_value_t* consts = realloc(ds->consts, (ds->const_count + 1) * sizeof(binding_value_t));
+    if (!consts) render_abort("Failed to grow derived state constants");
+    if (value.type == BINDING_TYPE_STRING) value.as.s_val = strdup(value.as.s_val);
+    consts[ds->const_count] = value;
+    ds->consts = consts;
+    return derived_emit(dc, BINDING_OP_CONST, ds->const_count++, 0);
+}
+
+static bool derived_emit_input(DerivedCompiler* dc, const char* state_name) {
+    IRDerivedState* ds = dc->ds;
+    uint32_t index = 0;
+    while (index < ds->input_count && strcmp(ds->inputs[index], state_name) != 0) index++;
+    if (index == ds->input_count) {
+        char** inputs = realloc(ds->inputs, (ds->input_count + 1) * sizeof(char*));
+        if (!inputs) render_abort("Failed to grow derived state inputs");
+        inputs[ds->input_count++] = strdup(state_name);
+        ds->inputs = inputs;
+    }
+    return derived_emit(dc, BINDING_OP_INPUT, index, 0);
+}
+
+// Compiles the [condition, value] pairs starting at `pair`.
+static bool compile_case_pairs(DerivedCompiler* dc, cJSON* pair) {
+    uint32_t pairs = 0;
+    cJSON* last_condition = NULL;
+    for (; pair; pair = pair->next, pairs++) {
+        if (!cJSON_IsArray(pair) || cJSON_GetArraySize(pair) != 2) {
+            print_warning("Derived state '%s': 'case' entries must be [condition, value] pairs.", dc->ds->state_name);
+            return false;
+        }
+        if (!compile_derived_expr(dc, pair->child) || !compile_derived_expr(dc, pair->child->next)) return false;
+        last_condition = pair->child;
+    }
+    if (pairs == 0) {
+        print_warning("Derived state '%s': 'case' needs at least one pair.", dc->ds->state_name);
+        return false;
+    }
+    // With no match the result is null, which UI-Sim stores in the state while
+    // the binding runtime keeps the state's last value.
+    if (!cJSON_IsTrue(last_condition)) {
+        print_warning("Derived state '%s': 'case' has no final [true, value] pair. When no condition holds, UI-Sim sets the state to null but the generated code keeps its last value.",
+                      dc->ds->state_name);
+    }
+    return derived_emit(dc, BINDING_OP_CASE, pairs, 2 * pairs);
+}
+
+// Follows UI-Sim's parse_expression(): strings naming a state defined earlier are
+// inputs ("!name" negates one), other strings, numbers and bools are constants.
+static bool compile_derived_expr(DerivedCompiler* dc, cJSON* json) {
+    const char* state_name = dc->ds->state_name;
+    if (cJSON_IsNumber(json)) {
+        return derived_emit_const(dc, (binding_value_t){ .type = BINDING_TYPE_DOUBLE, .as.d_val = json->valuedouble });
+    }
+    if (cJSON_IsBool(json)) {
+        return derived_emit_const(dc, (binding_value_t){ .type = BINDING_TYPE_BOOL, .as.b_val = cJSON_IsTrue(json) });
+    }
+    if (cJSON_IsString(json)) {
+        const char* s = json->valuestring;
+        if (strncmp(s, "value.", 6) == 0) {
+            print_warning("Derived state '%s' cannot use the action payload '%s'.", state_name, s);
+            return false;
+        }
+        bool is_negated = s[0] == '!';
+        const char* ref = is_negated ? s + 1 : s;
+        if (cJSON_GetObjectItemCaseSensitive(dc->known_states, ref)) {
+            if (!derived_emit_input(dc, ref)) return false;
+            return !is_negated || derived_emit(dc, BINDING_OP_NOT, 0, 1);
+        }
+        return derived_emit_const(dc, (binding_value_t){ .type = BINDING_TYPE_STRING, .as.s_val = s });
+    }
+    if (cJSON_IsObject(json)) {
+        cJSON* case_json = cJSON_GetObjectItemCaseSensitive(json, "case");
+        if (case_json && cJSON_IsArray(case_json)) return compile_case_pairs(dc, case_json->child);
+    }
+    if (cJSON_IsArray(json) && json->child) {
+        const char* func_name = cJSON_GetStringValue(json->child);
+        if (func_name && strcmp(func_name, "case") == 0) return compile_case_pairs(dc, json->child->next);
+
+        const DerivedFunction* fn = NULL;
+        for (size_t i = 0; func_name && i < sizeof(derived_functions) / sizeof(derived_functions[0]); i++) {
+            if (strcmp(func_name, derived_functions[i].name) == 0) fn = &derived_functions[i];
+        }
+        if (!fn) {
+            print_warning("Derived state '%s': lists other than 'case' pairs must start with a function name.", state_name);
+            return false;
+        }
+        uint32_t argc = (uint32_t)cJSON_GetArraySize(json) - 1;
+        if (argc < fn->min_args || (fn->max_args && argc > fn->max_args)) {
+            print_warning("Derived state '%s': wrong number of arguments for '%s'.", state_name, func_name);
+            return false;
+        }
+        for (cJSON* arg = json->child->next; arg; arg = arg->next) {
+            if (!compile_derived_expr(dc, arg)) return false;
+        }
+        return derived_emit(dc, fn->op, fn->max_args ? 0 : argc, argc);
+    }
+    print_warning("Derived state '%s' has an invalid expression.", state_name);
+    return false;
+}
+
+// Compiles the derived states of a `data-binding` node that ui_sim_process_node()
+// has accepted. Like UI-Sim, an expression may name any state of its node, and the
+// names stay known for the expressions of later nodes.
+static void collect_derived_states(GenContext* ctx, cJSON* binding_json) {
+    cJSON* state_json = cJSON_GetObjectItemCaseSensitive(binding_json, "state");
+    cJSON* item;
+    cJSON_ArrayForEach(item, state_json) {
+        cJSON* state_def = item->child;
+        if (!state_def || !state_def->string) continue;
+        if (!cJSON_GetObjectItemCaseSensitive(ctx->sim_state_names, state_def->string)) {
+            cJSON_AddItemToObject(ctx->sim_state_names, state_def->string, cJSON_CreateTrue());
+        }
+    }
+    cJSON_ArrayForEach(item, state_json) {
+        cJSON* state_def = item->child;
+        if (!state_def || !state_def->string) continue;
+        cJSON* expr_json = cJSON_IsObject(state_def) ? cJSON_GetObjectItemCaseSensitive(state_def, "derived_expr") : NULL;
+        if (expr_json) {
+            IRDerivedState* ds = ir_new_derived_state(state_def->string);
+            DerivedCompiler dc = { .ds = ds, .known_states = ctx->sim_state_names, .depth = 0 };
+            if (compile_derived_expr(&dc, expr_json)) {
+                ir_derived_state_list_add(ctx->derived_states, ds);
+            } else {
+                print_warning("Derived state '%s' is only computed by UI-Sim, not by the generated code.", state_def->string);
+                ir_free((IRNode*)ds);
+            }
+        }
+    }
+}
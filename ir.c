@@ -16,6 +16,7 @@ static void free_object_list(IRObject* head);
 static void free_component_def_list(IRComponent* head);
 static void free_expr(IRExpr* expr);
 static void free_operation_list(IROperationNode* head);
+static void free_derived_state_list(IRDerivedState* head);
 
 // --- Factory functions for Expressions ---
 
@@ -184,6 +185,13 @@ IRAction* ir_new_action(const char* action_name, action_type_t action_type, IREx
     return act;
 }
 
+IRDerivedState* ir_new_derived_state(const char* state_name) {
+    IRDerivedState* ds = calloc(1, sizeof(IRDerivedState));
+    ds->base.type = IR_NODE_DERIVED_STATE;
+    ds->state_name = safe_strdup(state_name);
+    return ds;
+}
+
 
 // --- List Management ---
 #define IMPLEMENT_LIST_ADD(func_name, node_type, list_head_type) \
@@ -202,6 +210,7 @@ IMPLEMENT_LIST_ADD(ir_object_list_add, IRObject, IRObject)
 IMPLEMENT_LIST_ADD(ir_property_list_add, IRProperty, IRProperty)
 IMPLEMENT_LIST_ADD(ir_with_block_list_add, IRWithBlock, IRWithBlock)
 IMPLEMENT_LIST_ADD(ir_component_def_list_add, IRComponent, IRComponent)
+IMPLEMENT_LIST_ADD(ir_derived_state_list_add, IRDerivedState, IRDerivedState)
 
 void ir_expr_list_add(IRExprNode** head, IRExpr* expr) {
     if (!head || !expr) return;
@@ -318,6 +327,15 @@ static void free_component_def_list(IRComponent* head) {
     }
 }
 
+static void free_derived_state_list(IRDerivedState* head) {
+    IRDerivedState* current = head;
+    while (current) {
+        IRDerivedState* next = current->next;
+        ir_free((IRNode*)current);
+        current = next;
+    }
+}
+
 static void free_operation_list(IROperationNode* head) {
     IROperationNode* current = head;
     while (current) {
@@ -336,6 +354,7 @@ void ir_free(IRNode* node) {
             IRRoot* root = (IRRoot*)node;
             free_component_def_list(root->components);
             free_object_list(root->root_objects);
+            free_derived_state_list(root->derived_states);
             break;
         }
         case IR_NODE_OBJECT: {
@@ -387,6 +406,18 @@ void ir_free(IRNode* node) {
             free_expr(act->data_expr);
             break;
         }
+        case IR_NODE_DERIVED_STATE: {
+            IRDerivedState* ds = (IRDerivedState*)node;
+            free(ds->state_name);
+            free(ds->code);
+            for (uint32_t i = 0; i < ds->const_count; i++) {
+                if (ds->consts[i].type == BINDING_TYPE_STRING) free((void*)ds->consts[i].as.s_val);
+            }
+            free(ds->consts);
+            for (uint32_t i = 0; i < ds->input_count; i++) free(ds->inputs[i]);
+            free(ds->inputs);
+            break;
+        }
         case IR_EXPR_LITERAL:
         case IR_EXPR_STATIC_STRING:
         case IR_EXPR_ENUM:
@@ -15,6 +15,7 @@ struct IRWithBlock;
 struct IRComponent;
 struct IRObserver;
 struct IRAction;
+struct IRDerivedState;
 
 // --- Base IR Node ---
 typedef struct IRNode {
@@ -30,6 +31,7 @@ typedef struct IRNode {
         IR_NODE_WITH_BLOCK,
         IR_NODE_OBSERVER,
         IR_NODE_ACTION,
+        IR_NODE_DERIVED_STATE,
 
         // Expression nodes
         IR_EXPR_LITERAL,
@@ -149,8 +151,24 @@ typedef struct IRAction {
     char* action_name;
     action_type_t action_type;
     IRExpr* data_expr; // For cycle lists or slider configs
+    uint32_t throttle_ms; // Rate limits passed to data_binding_add_action(), 0 if unset
+    uint32_t debounce_ms;
 } IRAction;
 
+// Data binding: a derived state, compiled from a UI-Sim `derived_expr` into the
+// bytecode taken by data_binding_add_derived_state()
+typedef struct IRDerivedState {
+    IRNode base;
+    char* state_name;
+    binding_expr_instr_t* code;
+    uint32_t code_len;
+    binding_value_t* consts; // Owns the strings of BINDING_TYPE_STRING constants
+    uint32_t const_count;
+    char** inputs;           // Input state names, indexed by BINDING_OP_INPUT
+    uint32_t input_count;
+    struct IRDerivedState* next;
+} IRDerivedState;
+
 
 // A property on an object (e.g., width: 100)
 typedef struct IRProperty {
@@ -203,6 +221,7 @@ typedef struct {
     IRNode base;
     IRComponent* components;
     IRObject* root_objects;
+    IRDerivedState* derived_states; // In definition order; may read states defined later
 } IRRoot;
 
 
@@ -227,6 +246,7 @@ IRWithBlock* ir_new_with_block(IRExpr* target, IRExprNode* calls, IRObject* chil
 IRWarning* ir_new_warning(const char* message);
 IRObserver* ir_new_observer(const char* state_name, observer_update_type_t update_type, IRExpr* config_expr);
 IRAction* ir_new_action(const char* action_name, action_type_t action_type, IRExpr* data);
+IRDerivedState* ir_new_derived_state(const char* state_name);
 
 // --- List management helpers ---
 void ir_expr_list_add(IRExprNode** head, IRExpr* expr);
@@ -235,6 +255,7 @@ void ir_property_list_add(IRProperty** head, IRProperty* prop);
 void ir_with_block_list_add(IRWithBlock** head, IRWithBlock* block);
 void ir_component_def_list_add(IRComponent** head, IRComponent* comp);
 void ir_operation_list_add(IROperationNode** head, IRNode* node);
+void ir_derived_state_list_add(IRDerivedState** head, IRDerivedState* state);
 
 // --- Memory Management ---
 void ir_free(IRNode* node);
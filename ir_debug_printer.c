@@ -23,6 +23,7 @@ static const char* get_ir_node_type_str(int type) {
         case IR_NODE_WARNING: return "IR_NODE_WARNING";
         case IR_NODE_OBSERVER: return "IR_NODE_OBSERVER";
         case IR_NODE_ACTION: return "IR_NODE_ACTION";
+        case IR_NODE_DERIVED_STATE: return "IR_NODE_DERIVED_STATE";
         case IR_EXPR_LITERAL: return "IR_EXPR_LITERAL";
         case IR_EXPR_ENUM: return "IR_EXPR_ENUM";
         case IR_EXPR_FUNCTION_CALL: return "IR_EXPR_FUNCTION_CALL";
@@ -115,7 +116,11 @@ static void debug_print_node(IRNode* node, int indent_level) {
         }
         case IR_NODE_ACTION: {
             IRAction* act = (IRAction*)node;
-            printf("name=\"%s\" type=%d\n", act->action_name, act->action_type);
+            printf("name=\"%s\" type=%d", act->action_name, act->action_type);
+            if (act->throttle_ms || act->debounce_ms) {
+                printf(" throttle_ms=%u debounce_ms=%u", (unsigned)act->throttle_ms, (unsigned)act->debounce_ms);
+            }
+            printf("\n");
             if (act->data_expr) {
                 debug_print_indent(indent_level + 1);
                 printf("[DATA_EXPR]\n");
@@ -208,4 +213,16 @@ void ir_debug_print_backend(IRRoot* root, const ApiSpec* api_spec) {
         debug_print_indent(1);
         printf("(No root objects)\n");
     }
+    for (IRDerivedState* ds = root->derived_states; ds; ds = ds->next) {
+        debug_print_indent(1);
+        printf("[%s] state=\"%s\"\n", get_ir_node_type_str(ds->base.type), ds->state_name);
+        for (uint32_t i = 0; i < ds->input_count; i++) {
+            debug_print_indent(2);
+            printf("input[%u]=\"%s\"\n", (unsigned)i, ds->inputs[i]);
+        }
+        for (uint32_t i = 0; i < ds->code_len; i++) {
+            debug_print_indent(2);
+            printf("op=%u arg=%u\n", (unsigned)ds->code[i].op, (unsigned)ds->code[i].arg);
+        }
+    }
 }
@@ -112,6 +112,9 @@ static void print_node(IRNode* node, int indent_level) {
             } else {
                 printf("NULL");
             }
+            if (act->throttle_ms || act->debounce_ms) {
+                printf(", throttle_ms=%u, debounce_ms=%u", (unsigned)act->throttle_ms, (unsigned)act->debounce_ms);
+            }
             printf(")\n");
             break;
         }
@@ -212,4 +215,13 @@ void ir_print_backend(IRRoot* root, const ApiSpec* api_spec) {
         print_indent(1);
         printf("(No root objects)\n");
     }
+
+    for (IRDerivedState* ds = root->derived_states; ds; ds = ds->next) {
+        print_indent(1);
+        printf("derived_state(\"%s\", instructions=%u, consts=%u, inputs=[", ds->state_name, (unsigned)ds->code_len, (unsigned)ds->const_count);
+        for (uint32_t i = 0; i < ds->input_count; i++) {
+            printf("%s\"%s\"", i ? ", " : "", ds->inputs[i]);
+        }
+        printf("])\n");
+    }
 }
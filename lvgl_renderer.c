@@ -296,7 +296,8 @@ static void render_single_object(RenderContext* ctx, IRObject* current_obj) {
                     free(cycle_values);
                     continue;
                 }
-                data_binding_add_action(c_obj, act->action_name, act->action_type, cycle_values, cycle_count, config_data);
+                data_binding_add_action(c_obj, act->action_name, act->action_type, cycle_values, cycle_count, config_data,
+                                        act->throttle_ms, act->debounce_ms);
                 if (cycle_values) free(cycle_values);
             } else {
                 RenderValue ignored;
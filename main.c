@@ -41,6 +41,7 @@ bool g_ui_sim_trace_no_time_enabled = false; // Not used in main, but defined to
 void print_usage(const char* prog_name);
 int run_sim_test_mode(const char* api_spec_path, const char* ui_spec_path, int num_ticks);
 int run_yaml_parse_mode(const char* yaml_path);
+void print_binding_stats(void);
 
 
 // --- Main Application ---
@@ -51,13 +52,14 @@ void print_usage(const char* prog_name) {
     fprintf(stderr, "  --parse-yaml-to-json <file.yaml>  Parse YAML and print resulting JSON to stdout.\n");
     fprintf(stderr, "  --run-sim-test <ticks> --api-spec <api.json> --ui-spec <ui.yaml> Run UI-Sim test.\n");
     fprintf(stderr, "\nStandard Options:\n");
-    fprintf(stderr, "  --codegen <backends>     Comma-separated list of backends (ir_print, c_code, lvgl_render).\n");
+    fprintf(stderr, "  --codegen <backends>     Comma-separated list of backends (ir_print, c_code, c_header, lvgl_render).\n");
     fprintf(stderr, "  --debug_out <modules>    Comma-separated list of debug modules to enable (e.g., 'GENERATOR,RENDERER' or 'ALL').\n");
     fprintf(stderr, "  --strict                 Enable strict mode (fail on warnings).\n");
     fprintf(stderr, "  --strict-registry        Fail only on unresolved registry references.\n");
     fprintf(stderr, "  --screenshot-and-exit <path> For visual testing. Renders UI, saves screenshot, and exits.\n");
     fprintf(stderr, "  --watch                  Enable live-reloading of the UI spec file.\n");
     fprintf(stderr, "  --trace-sim              Enable UI-Sim tracing in normal lvgl_render mode.\n");
+    fprintf(stderr, "  --binding-stats          Print per-state data binding statistics when the viewer exits.\n");
 }
 
 void render_abort(const char *msg) {
@@ -97,6 +99,35 @@ int run_yaml_parse_mode(const char* yaml_path) {
 }
 
 
+static int compare_stats_by_area(const void* a, const void* b) {
+    const data_binding_state_stats_t* sa = a;
+    const data_binding_state_stats_t* sb = b;
+    if (sa->invalidated_area != sb->invalidated_area) return sa->invalidated_area < sb->invalidated_area ? 1 : -1;
+    return (sa->widget_updates < sb->widget_updates) - (sa->widget_updates > sb->widget_updates);
+}
+
+// Prints the binding statistics, most expensive states (by invalidated area) first.
+void print_binding_stats(void) {
+    uint32_t count = data_binding_get_stats(NULL, 0);
+    if (count == 0) {
+        fprintf(stderr, "--- Binding Stats: no states ---\n");
+        return;
+    }
+    data_binding_state_stats_t* stats = malloc(count * sizeof(data_binding_state_stats_t));
+    if (!stats) render_abort("Failed to allocate binding stats.");
+    data_binding_get_stats(stats, count);
+    qsort(stats, count, sizeof(data_binding_state_stats_t), compare_stats_by_area);
+
+    fprintf(stderr, "--- Binding Stats ---\n");
+    fprintf(stderr, "%-32s %10s %10s %10s %14s\n", "state", "notifies", "applied", "updates", "inval_px");
+    for (uint32_t i = 0; i < count; i++) {
+        fprintf(stderr, "%-32s %10u %10u %10u %14llu\n", stats[i].state_name,
+                stats[i].notify_count, stats[i].apply_count, stats[i].widget_updates,
+                (unsigned long long)stats[i].invalidated_area);
+    }
+    free(stats);
+}
+
 int run_sim_test_mode(const char* api_spec_path, const char* ui_spec_path, int num_ticks) {
     g_ui_sim_trace_enabled = true;
 
@@ -174,6 +205,7 @@ int main(int argc, char* argv[]) {
     const char* debug_out_str = NULL;
     const char* screenshot_path = NULL;
     bool watch_mode = false;
+    bool binding_stats = false;
 
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "--codegen") == 0 && i + 1 < argc) { codegen_list_str = argv[++i]; }
@@ -183,6 +215,7 @@ int main(int argc, char* argv[]) {
         else if (strcmp(argv[i], "--strict-registry") == 0) { g_strict_registry_mode = true; }
         else if (strcmp(argv[i], "--watch") == 0) { watch_mode = true; }
         else if (strcmp(argv[i], "--trace-sim") == 0) { g_ui_sim_trace_enabled = true; }
+        else if (strcmp(argv[i], "--binding-stats") == 0) { binding_stats = true; }
         else if (strcmp(argv[i], "--run-sim-test") == 0) { i++; continue; } // Skip already handled args
         else if (strcmp(argv[i], "--api-spec") == 0) { i++; continue; }   // Skip already handled args
         else if (strcmp(argv[i], "--ui-spec") == 0) { i++; continue; }    // Skip already handled args
@@ -223,6 +256,7 @@ int main(int argc, char* argv[]) {
         if (strcmp(backend_name, "ir_print") == 0) { ir_print_backend(ir_root, api_spec); }
         else if (strcmp(backend_name, "ir_debug_print") == 0) { ir_debug_print_backend(ir_root, api_spec); }
         else if (strcmp(backend_name, "c_code") == 0) { c_code_print_backend(ir_root, api_spec); }
+        else if (strcmp(backend_name, "c_header") == 0) { c_header_print_backend(ir_root, api_spec); }
         else if (strcmp(backend_name, "lvgl_render") == 0) {
             DEBUG_LOG(LOG_MODULE_MAIN, "Executing 'lvgl_render' backend.");
 
@@ -230,6 +264,7 @@ int main(int argc, char* argv[]) {
 
             lv_obj_t* screen = sdl_viewer_create_main_screen();
             if (!screen) { fprintf(stderr, "FATAL: Failed to create main screen.\n"); sdl_viewer_deinit(); return_code = 1; goto cleanup; }
+            if (binding_stats) { data_binding_set_stats_enabled(true); }
 
             lv_obj_t* preview_panel = screen;
             lv_obj_t* inspector_panel = NULL;
@@ -273,6 +308,10 @@ int main(int argc, char* argv[]) {
                 }
             }
 
+            if (binding_stats) {
+                print_binding_stats();
+                data_binding_set_stats_enabled(false);
+            }
             sdl_viewer_deinit();
             obj_registry_deinit();
 
@@ -0,0 +1,142 @@
+/**
+ * @file binding_test.c
+ * @brief Regression tests for the data binding core.
+ *
+ * Builds widgets on a dummy LVGL display (no SDL), drives them through
+ * notifications and checks what the widgets show. Prints one line per test
+ * and exits with 1 if any check failed.
+ *
+ * Build and run with `make binding-test`.
+ */
+#include "data_binding.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_HOR_RES 320
+#define TEST_VER_RES 240
+
+static lv_color32_t draw_buf[TEST_HOR_RES * 20];
+static int failed_checks = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "  %s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); failed_checks++; } \
+} while (0)
+
+static void test_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    (void)area;
+    (void)px_map;
+    lv_display_flush_ready(disp);
+}
+
+void render_abort(const char* msg) {
+    fprintf(stderr, "\nFATAL ERROR: %s\n\n", msg);
+    exit(1);
+}
+
+static binding_value_t int_value(int32_t v) { return (binding_value_t){ .type = BINDING_TYPE_INT, .as.i_val = v }; }
+static binding_value_t bool_value(bool v) { return (binding_value_t){ .type = BINDING_TYPE_BOOL, .as.b_val = v }; }
+
+static uint32_t applies_of(const char* state_name) {
+    data_binding_state_stats_t stats[16];
+    uint32_t n = data_binding_get_stats(stats, 16);
+    for (uint32_t i = 0; i < n && i < 16; i++) {
+        if (strcmp(stats[i].state_name, state_name) == 0) return stats[i].apply_count;
+    }
+    return 0;
+}
+
+// A STYLE observer drops its style while the widget is disabled. Republishing
+// the same value once the widget is enabled again must bring the style back.
+static void test_style_after_disable(void) {
+    static lv_style_t style_on;
+    lv_style_init(&style_on);
+    lv_style_set_bg_opa(&style_on, 123);
+    static const bool disabled_when_true = true;
+    static binding_map_entry_t style_map[] = {
+        { .key = { .type = BINDING_TYPE_INT, .as.i_val = 1 }, .value.p_val = &style_on },
+    };
+
+    lv_obj_t* widget = lv_obj_create(lv_screen_active());
+    data_binding_add_observer("mode", widget, OBSERVER_TYPE_STYLE, style_map, 1, NULL);
+    data_binding_add_observer("locked", widget, OBSERVER_TYPE_DISABLED, &disabled_when_true, 0, NULL);
+
+    data_binding_notify_state_changed("mode", int_value(1));
+    CHECK(lv_obj_get_style_bg_opa(widget, LV_PART_MAIN) == 123);
+
+    data_binding_notify_state_changed("locked", bool_value(true));
+    data_binding_notify_state_changed("mode", int_value(1));
+    CHECK(lv_obj_has_state(widget, LV_STATE_DISABLED));
+    CHECK(lv_obj_get_style_bg_opa(widget, LV_PART_MAIN) != 123);
+
+    data_binding_notify_state_changed("locked", bool_value(false));
+    data_binding_notify_state_changed("mode", int_value(1));
+    CHECK(!lv_obj_has_state(widget, LV_STATE_DISABLED));
+    CHECK(lv_obj_get_style_bg_opa(widget, LV_PART_MAIN) == 123);
+}
+
+// The user can change a checkbox or a slider behind the binding's back. The app
+// puts them right by republishing the state's value, which must not be dropped.
+static void test_republish_after_user_input(void) {
+    static const bool checked_when_true = true;
+    lv_obj_t* checkbox = lv_checkbox_create(lv_screen_active());
+    data_binding_add_observer("enabled", checkbox, OBSERVER_TYPE_CHECKED, &checked_when_true, 0, NULL);
+    data_binding_notify_state_changed("enabled", bool_value(true));
+    CHECK(lv_obj_has_state(checkbox, LV_STATE_CHECKED));
+    lv_obj_remove_state(checkbox, LV_STATE_CHECKED); // As a click would
+    data_binding_notify_state_changed("enabled", bool_value(true));
+    CHECK(lv_obj_has_state(checkbox, LV_STATE_CHECKED));
+
+    static const lv_anim_enable_t no_anim = LV_ANIM_OFF;
+    lv_obj_t* slider = lv_slider_create(lv_screen_active());
+    data_binding_add_observer("speed", slider, OBSERVER_TYPE_VALUE, &no_anim, sizeof(no_anim), NULL);
+    data_binding_notify_state_changed("speed", int_value(40));
+    CHECK(lv_slider_get_value(slider) == 40);
+    lv_slider_set_value(slider, 75, LV_ANIM_OFF); // As a drag would
+    data_binding_notify_state_changed("speed", int_value(40));
+    CHECK(lv_slider_get_value(slider) == 40);
+}
+
+// States whose widgets only display the value still drop unchanged notifications.
+static void test_unchanged_label_skipped(void) {
+    lv_obj_t* label = lv_label_create(lv_screen_active());
+    data_binding_add_observer("status", label, OBSERVER_TYPE_TEXT, "%d", 0, NULL);
+    data_binding_reset_stats();
+    data_binding_notify_state_changed("status", int_value(7));
+    data_binding_notify_state_changed("status", int_value(7));
+    CHECK(strcmp(lv_label_get_text(label), "7") == 0);
+    CHECK(applies_of("status") == 1);
+}
+
+typedef struct {
+    const char* name;
+    void (*run)(void);
+} test_case_t;
+
+static const test_case_t test_cases[] = {
+    { "style_after_disable",        test_style_after_disable },
+    { "republish_after_user_input", test_republish_after_user_input },
+    { "unchanged_label_skipped",    test_unchanged_label_skipped },
+};
+
+int main(void) {
+    lv_init();
+    lv_display_t* disp = lv_display_create(TEST_HOR_RES, TEST_VER_RES);
+    lv_display_set_buffers(disp, draw_buf, NULL, sizeof(draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, test_flush_cb);
+    data_binding_set_stats_enabled(true);
+
+    int failed_tests = 0;
+    for (size_t i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
+        int failed_before = failed_checks;
+        lv_obj_clean(lv_screen_active());
+        data_binding_init();
+        test_cases[i].run();
+        bool passed = failed_checks == failed_before;
+        if (!passed) failed_tests++;
+        printf("%s %s\n", passed ? "PASS" : "FAIL", test_cases[i].name);
+    }
+    printf("%d of %d tests failed.\n", failed_tests, (int)(sizeof(test_cases) / sizeof(test_cases[0])));
+    return failed_tests ? 1 : 0;
+}
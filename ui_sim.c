@@ -21,7 +21,8 @@ typedef struct {
 typedef struct {
     bool is_active;
     bool has_definition;
-    uint32_t current_tick;
+    uint64_t current_tick;
+    double elapsed_time;      // Value of `time`, kept in double so that it still advances on long runs
 
     SimStateVariable states[UI_SIM_MAX_STATES];
     uint32_t state_count;
@@ -31,8 +32,17 @@ typedef struct {
 
     SimModification* updates_head;
 
-    SimScheduledAction scheduled_actions[UI_SIM_MAX_SCHEDULED_ACTIONS];
+    SimScheduledAction* scheduled_actions; // In spec order
     uint32_t scheduled_action_count;
+    uint32_t scheduled_action_capacity;
+    uint32_t* schedule_heap;               // Indices of pending actions, min-heap on (next_tick, index)
+    uint32_t schedule_heap_size;
+
+    int32_t time_slot;        // Slot of the `time` state, -1 if there is none
+    uint32_t derived_order[UI_SIM_MAX_STATES]; // Derived state slots, inputs before readers
+    uint32_t derived_count;
+    binding_value_t* vm_stack; // Shared by all programs, sized for the deepest one
+    uint32_t vm_stack_size;
 } SimContext;
 
 static SimContext g_sim;
@@ -50,15 +60,20 @@ static bool parse_actions(cJSON* action_array, SimParseContext* ctx);
 static bool parse_updates(cJSON* update_array, SimParseContext* ctx);
 static bool parse_schedule(cJSON* schedule_array, SimParseContext* ctx);
 static bool is_known_function(const char* name);
+static bool compile_definition(SimParseContext* ctx);
+static void free_program(SimProgram* prog);
 
 // --- Forward Declarations: Runtime ---
 static void sim_action_handler(const char* action_name, binding_value_t value, void* user_data);
 static bool execute_modifications_list(SimModification* head, binding_value_t action_value);
-static binding_value_t evaluate_expression(SimExpression* expr, binding_value_t action_value);
+static binding_value_t run_program(const SimProgram* prog, binding_value_t action_value);
 static void notify_changed_states(void);
+static void reset_schedule(void);
+static void run_scheduled_actions(void);
 static SimStateVariable* find_state(const char* name);
 static bool set_state_value(SimStateVariable* state, binding_value_t new_value);
 static bool values_are_equal(binding_value_t v1, binding_value_t v2);
+static void store_state_value(SimStateVariable* state, binding_value_t value);
 static void trace_print_value(binding_value_t v);
 
 
@@ -91,8 +106,10 @@ void ui_sim_init(void) {
 
     for (uint32_t i = 0; i < g_sim.state_count; i++) {
         free(g_sim.states[i].name);
-        if (g_sim.states[i].value.type == BINDING_TYPE_STRING) free((void*)g_sim.states[i].value.as.s_val);
+        free(g_sim.states[i].string_buf);
         free_expression(g_sim.states[i].derived_expr);
+        free_program(&g_sim.states[i].derived_prog);
+        free(g_sim.states[i].dependents);
     }
     for (uint32_t i = 0; i < g_sim.action_count; i++) {
         free(g_sim.actions[i].name);
@@ -105,6 +122,9 @@ void ui_sim_init(void) {
             free((void*)g_sim.scheduled_actions[i].value.as.s_val);
         }
     }
+    free(g_sim.scheduled_actions);
+    free(g_sim.schedule_heap);
+    free(g_sim.vm_stack);
 
     memset(&g_sim, 0, sizeof(SimContext));
     DEBUG_LOG(LOG_MODULE_DATABINDING, "UI Simulator initialized.");
@@ -135,6 +155,8 @@ bool ui_sim_process_node(cJSON* node) {
     cJSON* schedule_json = cJSON_GetObjectItem(node, "schedule");
     if (schedule_json && !parse_schedule(schedule_json, &ctx)) return false;
 
+    if (!compile_definition(&ctx)) return false;
+
     g_sim.has_definition = true;
     DEBUG_LOG(LOG_MODULE_DATABINDING, "Successfully processed UI-Sim definition.");
     return true;
@@ -149,12 +171,13 @@ void ui_sim_start(void) {
     data_binding_register_action_handler(sim_action_handler, NULL);
 
     g_sim.current_tick = 0;
+    g_sim.elapsed_time = g_sim.time_slot >= 0 ? g_sim.states[g_sim.time_slot].value.as.f_val : 0.0;
+    reset_schedule();
 
-    // Evaluate derived expressions on startup
-    for (uint32_t i = 0; i < g_sim.state_count; i++) {
-        if (g_sim.states[i].is_derived) {
-            g_sim.states[i].value = evaluate_expression(g_sim.states[i].derived_expr, (binding_value_t){.type=BINDING_TYPE_NULL});
-        }
+    // Evaluate derived expressions on startup, inputs before the states reading them.
+    for (uint32_t k = 0; k < g_sim.derived_count; k++) {
+        SimStateVariable* state = &g_sim.states[g_sim.derived_order[k]];
+        store_state_value(state, run_program(&state->derived_prog, (binding_value_t){.type=BINDING_TYPE_NULL}));
     }
 
     if (g_ui_sim_trace_enabled) {
@@ -184,24 +207,17 @@ void ui_sim_tick(float dt) {
     g_sim.current_tick++;
 
     // 1. Execute scheduled actions for this tick.
-    for (uint32_t i = 0; i < g_sim.scheduled_action_count; i++) {
-        if (g_sim.scheduled_actions[i].tick == g_sim.current_tick) {
-            binding_value_t value_copy = g_sim.scheduled_actions[i].value;
-            if (value_copy.type == BINDING_TYPE_STRING && value_copy.as.s_val) {
-                value_copy.as.s_val = strdup(value_copy.as.s_val);
-            }
-            sim_action_handler(g_sim.scheduled_actions[i].name, value_copy, NULL);
-        }
-    }
+    run_scheduled_actions();
 
     // 2. Run the updates block.
     execute_modifications_list(g_sim.updates_head, (binding_value_t){.type = BINDING_TYPE_NULL});
 
-    // 3. Increment time at the end of the tick logic.
-    SimStateVariable* time_state = find_state("time");
-    if (time_state) {
-        binding_value_t old_val = time_state->value;
-        binding_value_t new_val = {.type=BINDING_TYPE_FLOAT, .as.f_val = old_val.as.f_val + dt};
+    // 3. Increment time at the end of the tick logic. Adding dt to the float
+    // state itself would lose precision after 2^18 seconds and stall at 2^20.
+    g_sim.elapsed_time += dt;
+    if (g_sim.time_slot >= 0) {
+        SimStateVariable* time_state = &g_sim.states[g_sim.time_slot];
+        binding_value_t new_val = {.type=BINDING_TYPE_FLOAT, .as.f_val = (float)g_sim.elapsed_time};
         set_state_value(time_state, new_val);
     }
 
@@ -293,6 +309,10 @@ static void free_modification_list(SimModification* head) {
         free(head->target_state_name);
         free_expression(head->value_expr);
         free_expression(head->condition_expr);
+        free_program(&head->value_prog);
+        free_program(&head->condition_prog);
+        for (uint32_t i = 0; i < head->item_count; i++) free_program(&head->item_progs[i]);
+        free(head->item_progs);
         free(head);
         head = next;
     }
@@ -348,31 +368,38 @@ static bool parse_state(cJSON* state_array, SimParseContext* ctx) {
             else if (strcmp(type_str, "string") == 0) state->value.type = BINDING_TYPE_STRING;
             else { sim_abort(ctx, "Unknown state type '%s'. Use 'float', 'bool', or 'string'.", type_str); return false; }
 
-            if (state->value.type == BINDING_TYPE_STRING) state->value.as.s_val = strdup(cJSON_GetStringValue(val_json));
+            if (state->value.type == BINDING_TYPE_STRING) store_state_value(state, (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = cJSON_GetStringValue(val_json)});
             else if (state->value.type == BINDING_TYPE_BOOL) state->value.as.b_val = cJSON_IsTrue(val_json);
             else state->value.as.f_val = (float)val_json->valuedouble;
         } else if (cJSON_IsString(state_def)) {
             const char* type_str = state_def->valuestring;
             if (strcmp(type_str, "float") == 0) { state->value = (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = 0.0f}; }
             else if (strcmp(type_str, "bool") == 0) { state->value = (binding_value_t){.type = BINDING_TYPE_BOOL, .as.b_val = false}; }
-            else if (strcmp(type_str, "string") == 0) { state->value = (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = strdup("")}; }
+            else if (strcmp(type_str, "string") == 0) { store_state_value(state, (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = ""}); }
             else { // It's an inferred string initial value
-                state->value.type = BINDING_TYPE_STRING;
-                state->value.as.s_val = strdup(type_str);
+                store_state_value(state, (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = type_str});
             }
         } else if (cJSON_IsNumber(state_def)) {
             state->value = (binding_value_t){.type = BINDING_TYPE_FLOAT, .as.f_val = (float)state_def->valuedouble};
         } else if (cJSON_IsBool(state_def)) {
             state->value = (binding_value_t){.type = BINDING_TYPE_BOOL, .as.b_val = cJSON_IsTrue(state_def)};
         } else if (cJSON_IsObject(state_def) && cJSON_HasObjectItem(state_def, "derived_expr")) {
+            // The expression is parsed below, once every state it may reference exists.
             state->is_derived = true;
-            state->derived_expr = parse_expression(cJSON_GetObjectItem(state_def, "derived_expr"), ctx);
         } else {
              sim_abort(ctx, "Invalid format for state variable. Must be a type, a value, or [type, value].");
              return false;
         }
         g_sim.state_count++;
     }
+
+    uint32_t slot = 0;
+    cJSON_ArrayForEach(item, state_array) {
+        SimStateVariable* state = &g_sim.states[slot++];
+        if (!state->is_derived) continue;
+        ctx->current_key = state->name;
+        state->derived_expr = parse_expression(cJSON_GetObjectItem(item->child, "derived_expr"), ctx);
+    }
     ctx->current_key = NULL;
     return true;
 }
@@ -425,10 +452,6 @@ static bool parse_updates(cJSON* update_array, SimParseContext* ctx) {
 static bool parse_schedule(cJSON* schedule_array, SimParseContext* ctx) {
     cJSON* item;
     cJSON_ArrayForEach(item, schedule_array) {
-        if (g_sim.scheduled_action_count >= UI_SIM_MAX_SCHEDULED_ACTIONS) {
-            sim_abort(ctx, "Exceeded maximum number of scheduled actions (%d).", UI_SIM_MAX_SCHEDULED_ACTIONS);
-            return false;
-        }
         if (!cJSON_IsObject(item)) {
             sim_abort(ctx, "Invalid 'schedule' entry. Each entry must be an object.");
             return false;
@@ -437,14 +460,39 @@ static bool parse_schedule(cJSON* schedule_array, SimParseContext* ctx) {
         cJSON* tick_json = cJSON_GetObjectItem(item, "tick");
         cJSON* action_json = cJSON_GetObjectItem(item, "action");
         cJSON* with_json = cJSON_GetObjectItem(item, "with");
+        cJSON* every_json = cJSON_GetObjectItem(item, "every");
+        cJSON* times_json = cJSON_GetObjectItem(item, "times");
 
         if (!tick_json || !cJSON_IsNumber(tick_json) || !action_json || !cJSON_IsString(action_json)) {
             sim_abort(ctx, "Scheduled action requires a numeric 'tick' and a string 'action'.");
             return false;
         }
+        ctx->current_key = action_json->valuestring;
+        if (tick_json->valuedouble < 0) {
+            sim_abort(ctx, "Scheduled action 'tick' must not be negative.");
+            return false;
+        }
+        if (every_json && (!cJSON_IsNumber(every_json) || every_json->valuedouble < 1)) {
+            sim_abort(ctx, "Scheduled action 'every' must be a number of ticks of at least 1.");
+            return false;
+        }
+        if (times_json && (!every_json || !cJSON_IsNumber(times_json) || times_json->valuedouble < 1)) {
+            sim_abort(ctx, "Scheduled action 'times' must be a positive number and needs 'every'.");
+            return false;
+        }
 
+        if (g_sim.scheduled_action_count == g_sim.scheduled_action_capacity) {
+            uint32_t new_capacity = g_sim.scheduled_action_capacity ? g_sim.scheduled_action_capacity * 2 : 16;
+            SimScheduledAction* grown = realloc(g_sim.scheduled_actions, new_capacity * sizeof(SimScheduledAction));
+            if (!grown) { sim_abort(ctx, "Out of memory"); return false; }
+            g_sim.scheduled_actions = grown;
+            g_sim.scheduled_action_capacity = new_capacity;
+        }
         SimScheduledAction* sa = &g_sim.scheduled_actions[g_sim.scheduled_action_count];
-        sa->tick = (uint32_t)tick_json->valuedouble;
+        memset(sa, 0, sizeof(SimScheduledAction));
+        sa->tick = (uint64_t)tick_json->valuedouble;
+        sa->every = every_json ? (uint64_t)every_json->valuedouble : 0;
+        sa->times = times_json ? (uint32_t)times_json->valuedouble : 0;
         sa->name = strdup(action_json->valuestring);
         if (!sa->name) { sim_abort(ctx, "Out of memory"); return false; }
 
@@ -459,6 +507,10 @@ static bool parse_schedule(cJSON* schedule_array, SimParseContext* ctx) {
         g_sim.scheduled_action_count++;
     }
     ctx->current_key = NULL;
+
+    // Each action is in the heap at most once, so the heap never outgrows the schedule.
+    g_sim.schedule_heap = malloc((g_sim.scheduled_action_count ? g_sim.scheduled_action_count : 1) * sizeof(uint32_t));
+    if (!g_sim.schedule_heap) { sim_abort(ctx, "Out of memory"); return false; }
     return true;
 }
 
@@ -738,6 +790,288 @@ static SimExpression* parse_expression(cJSON* json, SimParseContext* ctx) {
     return expr;
 }
 
+// --- Expression Compiler ---
+
+typedef enum {
+    SIM_FN_ADD, SIM_FN_SUB, SIM_FN_MUL, SIM_FN_DIV, SIM_FN_SIN, SIM_FN_COS, SIM_FN_CLAMP,
+    SIM_FN_EQ, SIM_FN_NE, SIM_FN_GT, SIM_FN_LT, SIM_FN_GE, SIM_FN_LE,
+    SIM_FN_AND, SIM_FN_OR, SIM_FN_NOT,
+    SIM_FN_COUNT
+} SimFunction;
+
+// Indexed by SimFunction. "case" compiles to jumps and "pair" lists to null.
+static const char* const sim_function_names[SIM_FN_COUNT] = {
+    "add", "sub", "mul", "div", "sin", "cos", "clamp",
+    "==", "!=", ">", "<", ">=", "<=",
+    "and", "or", "not",
+};
+
+typedef struct {
+    SimProgram* prog;
+    SimParseContext* ctx;
+    uint32_t depth;     // Stack depth after the instructions emitted so far
+    uint32_t max_depth;
+    bool failed;
+} SimCompiler;
+
+static bool is_list_expression(const SimExpression* expr) {
+    return expr && expr->type == SIM_EXPR_FUNCTION && strcmp(expr->as.function.func_name, "pair") == 0;
+}
+
+// Appends an instruction that pops `pops` values and pushes `pushes`. Returns its index.
+static uint32_t sim_emit(SimCompiler* c, SimOpcode op, uint32_t arg, uint32_t argc, uint32_t pops, uint32_t pushes) {
+    SimProgram* prog = c->prog;
+    if (c->failed) return 0;
+    if (arg > UINT16_MAX || prog->code_len >= UINT16_MAX) {
+        sim_abort(c->ctx, "Expression is too large.");
+        c->failed = true;
+        return 0;
+    }
+    SimInstruction* code = realloc(prog->code, (prog->code_len + 1) * sizeof(SimInstruction));
+    if (!code) { sim_abort(c->ctx, "Out of memory"); c->failed = true; return 0; }
+    code[prog->code_len] = (SimInstruction){ .op = (uint8_t)op, .argc = (uint8_t)argc, .arg = (uint16_t)arg };
+    prog->code = code;
+    c->depth = c->depth - pops + pushes;
+    if (c->depth > c->max_depth) c->max_depth = c->depth;
+    return prog->code_len++;
+}
+
+static void sim_patch_jump(SimCompiler* c, uint32_t at) {
+    if (!c->failed) c->prog->code[at].arg = (uint16_t)c->prog->code_len;
+}
+
+static void compile_node(SimCompiler* c, const SimExpression* expr) {
+    if (!expr) {
+        sim_emit(c, SIM_OP_NULL, 0, 0, 0, 1);
+        return;
+    }
+    switch (expr->type) {
+        case SIM_EXPR_LITERAL: {
+            SimProgram* prog = c->prog;
+            binding_value_t* consts = realloc(prog->consts, (prog->const_count + 1) * sizeof(binding_value_t));
+            if (!consts) { sim_abort(c->ctx, "Out of memory"); c->failed = true; return; }
+            binding_value_t value = expr->as.literal;
+            if (value.type == BINDING_TYPE_STRING) value.as.s_val = strdup(value.as.s_val);
+            consts[prog->const_count] = value;
+            prog->consts = consts;
+            sim_emit(c, SIM_OP_CONST, prog->const_count++, 0, 0, 1);
+            return;
+        }
+        case SIM_EXPR_STATE_REF: {
+            // parse_expression() only makes references to states that exist.
+            uint32_t slot = (uint32_t)(find_state(expr->as.state_ref.state_name) - g_sim.states);
+            sim_emit(c, expr->as.state_ref.is_negated ? SIM_OP_STATE_NOT : SIM_OP_STATE, slot, 0, 0, 1);
+            return;
+        }
+        case SIM_EXPR_ACTION_VALUE:
+            sim_emit(c, SIM_OP_ACTION_VALUE, (uint32_t)expr->as.action_value_type, 0, 0, 1);
+            return;
+        case SIM_EXPR_FUNCTION:
+            break;
+    }
+
+    const char* name = expr->as.function.func_name;
+    if (strcmp(name, "case") == 0) {
+        // Each pair: condition, jump to the next pair unless true, value, jump to the end.
+        uint32_t end_jumps[UI_SIM_MAX_FUNC_ARGS];
+        uint32_t jump_count = 0;
+        uint32_t base_depth = c->depth;
+        int argc = 0;
+        for (SimExpressionNode* n = expr->as.function.args_head; n && argc < UI_SIM_MAX_FUNC_ARGS; n = n->next, argc++) {
+            if (!is_list_expression(n->expr) || !n->expr->as.function.args_head) continue;
+            SimExpressionNode* pair = n->expr->as.function.args_head;
+            compile_node(c, pair->expr);
+            uint32_t skip = sim_emit(c, SIM_OP_JUMP_UNLESS, 0, 0, 1, 0);
+            compile_node(c, pair->next ? pair->next->expr : NULL);
+            end_jumps[jump_count++] = sim_emit(c, SIM_OP_JUMP, 0, 0, 0, 0);
+            c->depth = base_depth; // The value is only on the stack on the taken branch
+            sim_patch_jump(c, skip);
+        }
+        sim_emit(c, SIM_OP_NULL, 0, 0, 0, 1);
+        for (uint32_t i = 0; i < jump_count; i++) sim_patch_jump(c, end_jumps[i]);
+        return;
+    }
+
+    int fn = -1;
+    for (int i = 0; i < SIM_FN_COUNT; i++) {
+        if (strcmp(name, sim_function_names[i]) == 0) { fn = i; break; }
+    }
+    if (fn < 0) { // A "pair" list used as a value
+        sim_emit(c, SIM_OP_NULL, 0, 0, 0, 1);
+        return;
+    }
+    uint32_t argc = 0;
+    for (SimExpressionNode* n = expr->as.function.args_head; n && argc < UI_SIM_MAX_FUNC_ARGS; n = n->next, argc++) {
+        compile_node(c, n->expr);
+    }
+    sim_emit(c, SIM_OP_CALL, (uint32_t)fn, argc, argc, 1);
+}
+
+static bool compile_program(SimProgram* prog, const SimExpression* expr, SimParseContext* ctx) {
+    SimCompiler c = { .prog = prog, .ctx = ctx };
+    compile_node(&c, expr);
+    if (c.failed) return false;
+    if (c.max_depth > g_sim.vm_stack_size) {
+        binding_value_t* stack = realloc(g_sim.vm_stack, c.max_depth * sizeof(binding_value_t));
+        if (!stack) { sim_abort(ctx, "Out of memory"); return false; }
+        g_sim.vm_stack = stack;
+        g_sim.vm_stack_size = c.max_depth;
+    }
+    return true;
+}
+
+static void free_program(SimProgram* prog) {
+    for (uint32_t i = 0; i < prog->const_count; i++) {
+        if (prog->consts[i].type == BINDING_TYPE_STRING) free((void*)prog->consts[i].as.s_val);
+    }
+    free(prog->consts);
+    free(prog->code);
+    memset(prog, 0, sizeof(SimProgram));
+}
+
+static bool compile_modifications(SimModification* head, SimParseContext* ctx) {
+    for (SimModification* mod = head; mod; mod = mod->next) {
+        ctx->current_key = mod->target_state_name;
+        SimStateVariable* target = mod->target_state_name ? find_state(mod->target_state_name) : NULL;
+        mod->target_slot = target ? (int32_t)(target - g_sim.states) : -1;
+        if (mod->condition_expr && !compile_program(&mod->condition_prog, mod->condition_expr, ctx)) return false;
+        if (is_list_expression(mod->value_expr)) {
+            mod->has_item_list = true;
+            uint32_t count = 0;
+            for (SimExpressionNode* n = mod->value_expr->as.function.args_head; n; n = n->next) count++;
+            mod->item_progs = calloc(count ? count : 1, sizeof(SimProgram));
+            if (!mod->item_progs) { sim_abort(ctx, "Out of memory"); return false; }
+            for (SimExpressionNode* n = mod->value_expr->as.function.args_head; n; n = n->next) {
+                if (!compile_program(&mod->item_progs[mod->item_count++], n->expr, ctx)) return false;
+            }
+        } else if (!compile_program(&mod->value_prog, mod->value_expr, ctx)) {
+            return false;
+        }
+        free_expression(mod->value_expr);
+        free_expression(mod->condition_expr);
+        mod->value_expr = NULL;
+        mod->condition_expr = NULL;
+    }
+    return true;
+}
+
+// Returns the first state slot read by `prog` that is derived and not yet placed
+// in the evaluation order, or -1.
+static int32_t find_unordered_input(const SimProgram* prog, const bool* ordered) {
+    for (uint32_t pc = 0; pc < prog->code_len; pc++) {
+        const SimInstruction* ins = &prog->code[pc];
+        if (ins->op != SIM_OP_STATE && ins->op != SIM_OP_STATE_NOT) continue;
+        if (g_sim.states[ins->arg].is_derived && !ordered[ins->arg]) return ins->arg;
+    }
+    return -1;
+}
+
+// Aborts with the names along one dependency cycle among the unordered derived states.
+static void report_derived_cycle(const bool* ordered, SimParseContext* ctx) {
+    int32_t step_of[UI_SIM_MAX_STATES];
+    for (uint32_t i = 0; i < g_sim.state_count; i++) step_of[i] = -1;
+
+    uint32_t slot = 0;
+    while (!g_sim.states[slot].is_derived || ordered[slot]) slot++;
+
+    // Every unordered state reads another unordered one, so this walk must revisit a state.
+    uint32_t path[UI_SIM_MAX_STATES + 1];
+    uint32_t path_len = 0;
+    while (step_of[slot] < 0) {
+        step_of[slot] = (int32_t)path_len;
+        path[path_len++] = slot;
+        slot = (uint32_t)find_unordered_input(&g_sim.states[slot].derived_prog, ordered);
+    }
+
+    char cycle[512] = "";
+    size_t used = 0;
+    for (uint32_t k = (uint32_t)step_of[slot]; k <= path_len && used < sizeof(cycle); k++) {
+        const char* name = g_sim.states[k < path_len ? path[k] : slot].name;
+        used += snprintf(cycle + used, sizeof(cycle) - used, "%s%s", used ? " -> " : "", name);
+    }
+    ctx->current_key = g_sim.states[slot].name;
+    sim_abort(ctx, "Derived states depend on each other in a cycle: %s", cycle);
+}
+
+// Links every derived state to the states its program reads and orders the derived
+// states so each one comes after all derived states it reads. Cycles are rejected.
+static bool build_derived_graph(SimParseContext* ctx) {
+    uint32_t unordered_inputs[UI_SIM_MAX_STATES] = {0};
+
+    for (uint32_t i = 0; i < g_sim.state_count; i++) {
+        if (!g_sim.states[i].is_derived) continue;
+        const SimProgram* prog = &g_sim.states[i].derived_prog;
+        for (uint32_t pc = 0; pc < prog->code_len; pc++) {
+            const SimInstruction* ins = &prog->code[pc];
+            if (ins->op != SIM_OP_STATE && ins->op != SIM_OP_STATE_NOT) continue;
+            SimStateVariable* input = &g_sim.states[ins->arg];
+            // Dependents are appended in slot order, so a repeated read ends the list.
+            if (input->dependent_count > 0 && input->dependents[input->dependent_count - 1] == i) continue;
+            uint32_t* grown = realloc(input->dependents, (input->dependent_count + 1) * sizeof(uint32_t));
+            if (!grown) { sim_abort(ctx, "Out of memory"); return false; }
+            input->dependents = grown;
+            input->dependents[input->dependent_count++] = i;
+            if (input->is_derived) unordered_inputs[i]++;
+        }
+    }
+
+    // Kahn's algorithm; derived_order doubles as the work queue.
+    bool ordered[UI_SIM_MAX_STATES] = {false};
+    uint32_t derived_total = 0;
+    g_sim.derived_count = 0;
+    for (uint32_t i = 0; i < g_sim.state_count; i++) {
+        if (!g_sim.states[i].is_derived) continue;
+        derived_total++;
+        if (unordered_inputs[i] == 0) {
+            ordered[i] = true;
+            g_sim.derived_order[g_sim.derived_count++] = i;
+        }
+    }
+    for (uint32_t head = 0; head < g_sim.derived_count; head++) {
+        const SimStateVariable* state = &g_sim.states[g_sim.derived_order[head]];
+        for (uint32_t k = 0; k < state->dependent_count; k++) {
+            uint32_t dependent = state->dependents[k];
+            if (--unordered_inputs[dependent] == 0) {
+                ordered[dependent] = true;
+                g_sim.derived_order[g_sim.derived_count++] = dependent;
+            }
+        }
+    }
+
+    if (g_sim.derived_count < derived_total) {
+        report_derived_cycle(ordered, ctx);
+        return false;
+    }
+    return true;
+}
+
+// Lowers every expression to a program once all states are known, and resolves
+// the state names used at runtime to slots.
+static bool compile_definition(SimParseContext* ctx) {
+    ctx->current_block = "state";
+    for (uint32_t i = 0; i < g_sim.state_count; i++) {
+        SimStateVariable* state = &g_sim.states[i];
+        if (!state->is_derived) continue;
+        ctx->current_key = state->name;
+        if (!compile_program(&state->derived_prog, state->derived_expr, ctx)) return false;
+        free_expression(state->derived_expr);
+        state->derived_expr = NULL;
+    }
+    if (!build_derived_graph(ctx)) return false;
+    ctx->current_block = "actions";
+    for (uint32_t i = 0; i < g_sim.action_count; i++) {
+        if (!compile_modifications(g_sim.actions[i].modifications_head, ctx)) return false;
+    }
+    ctx->current_block = "updates";
+    if (!compile_modifications(g_sim.updates_head, ctx)) return false;
+    ctx->current_key = NULL;
+
+    SimStateVariable* time_state = find_state("time");
+    g_sim.time_slot = time_state ? (int32_t)(time_state - g_sim.states) : -1;
+    return true;
+}
+
+
 // --- Runtime Logic ---
 
 static SimAction* find_action(const char* name) {
@@ -766,32 +1100,36 @@ static bool set_state_value(SimStateVariable* state, binding_value_t new_value)
                 fprintf(stderr, ")\n");
             }
         }
-        if(state->value.type == BINDING_TYPE_STRING) free((void*)state->value.as.s_val);
-
-        state->value = new_value;
+        store_state_value(state, new_value);
         state->is_dirty = true;
         return true;
-    } else {
-        if (new_value.type == BINDING_TYPE_STRING) {
-            free((void*)new_value.as.s_val);
-        }
     }
     return false;
 }
 
+static void mark_dependents(const SimStateVariable* state) {
+    for (uint32_t k = 0; k < state->dependent_count; k++) {
+        g_sim.states[state->dependents[k]].needs_eval = true;
+    }
+}
+
+// Re-evaluates only the derived states downstream of a changed state. derived_order
+// puts inputs first, so each derived state is evaluated at most once per call.
+static void update_derived_states(void) {
+    for (uint32_t i = 0; i < g_sim.state_count; i++) {
+        if (g_sim.states[i].is_dirty) mark_dependents(&g_sim.states[i]);
+    }
+    for (uint32_t k = 0; k < g_sim.derived_count; k++) {
+        SimStateVariable* state = &g_sim.states[g_sim.derived_order[k]];
+        if (!state->needs_eval) continue;
+        state->needs_eval = false;
+        binding_value_t derived_val = run_program(&state->derived_prog, (binding_value_t){.type=BINDING_TYPE_NULL});
+        if (set_state_value(state, derived_val)) mark_dependents(state);
+    }
+}
+
 static void notify_changed_states(void) {
-    bool derived_changed;
-    do {
-        derived_changed = false;
-        for(uint32_t i = 0; i < g_sim.state_count; i++) {
-            if (g_sim.states[i].is_derived) {
-                binding_value_t derived_val = evaluate_expression(g_sim.states[i].derived_expr, (binding_value_t){.type=BINDING_TYPE_NULL});
-                if(set_state_value(&g_sim.states[i], derived_val)) {
-                    derived_changed = true;
-                }
-            }
-        }
-    } while(derived_changed);
+    update_derived_states();
 
     for(uint32_t i = 0; i < g_sim.state_count; i++) {
         if (g_sim.states[i].is_dirty) {
@@ -822,9 +1160,69 @@ static void sim_action_handler(const char* action_name, binding_value_t value, v
     } else {
         print_warning("UI-Sim: Received unhandled action '%s'.", action_name);
     }
+    // The value is borrowed: string values belong to the caller (e.g. a cycle
+    // action's list) and are copied when stored.
+}
 
-    if (value.type == BINDING_TYPE_STRING && value.as.s_val) {
-        free((void*)value.as.s_val);
+// --- Schedule ---
+// Pending scheduled actions live in a binary min-heap keyed on their next tick,
+// so a tick only looks at the actions that are due. Ties run in spec order.
+
+static bool schedule_before(uint32_t a, uint32_t b) {
+    uint64_t ta = g_sim.scheduled_actions[a].next_tick, tb = g_sim.scheduled_actions[b].next_tick;
+    return ta < tb || (ta == tb && a < b);
+}
+
+static void schedule_push(uint32_t index) {
+    uint32_t* heap = g_sim.schedule_heap;
+    uint32_t pos = g_sim.schedule_heap_size++;
+    heap[pos] = index;
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (!schedule_before(heap[pos], heap[parent])) return;
+        uint32_t tmp = heap[pos]; heap[pos] = heap[parent]; heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+static uint32_t schedule_pop(void) {
+    uint32_t* heap = g_sim.schedule_heap;
+    uint32_t top = heap[0];
+    heap[0] = heap[--g_sim.schedule_heap_size];
+    uint32_t pos = 0;
+    for (;;) {
+        uint32_t child = 2 * pos + 1;
+        if (child >= g_sim.schedule_heap_size) break;
+        if (child + 1 < g_sim.schedule_heap_size && schedule_before(heap[child + 1], heap[child])) child++;
+        if (!schedule_before(heap[child], heap[pos])) break;
+        uint32_t tmp = heap[pos]; heap[pos] = heap[child]; heap[child] = tmp;
+        pos = child;
+    }
+    return top;
+}
+
+// Puts every scheduled action back to its first run. Called when the simulator starts.
+static void reset_schedule(void) {
+    g_sim.schedule_heap_size = 0;
+    for (uint32_t i = 0; i < g_sim.scheduled_action_count; i++) {
+        SimScheduledAction* sa = &g_sim.scheduled_actions[i];
+        sa->next_tick = sa->tick;
+        sa->runs = 0;
+        // Ticks count from 1, so an action at tick 0 never runs.
+        if (sa->tick > 0) schedule_push(i);
+    }
+}
+
+static void run_scheduled_actions(void) {
+    while (g_sim.schedule_heap_size > 0 && g_sim.scheduled_actions[g_sim.schedule_heap[0]].next_tick <= g_sim.current_tick) {
+        uint32_t index = schedule_pop();
+        SimScheduledAction* sa = &g_sim.scheduled_actions[index];
+        sim_action_handler(sa->name, sa->value, NULL);
+        sa->runs++;
+        if (sa->every > 0 && (sa->times == 0 || sa->runs < sa->times)) {
+            sa->next_tick += sa->every;
+            schedule_push(index);
+        }
     }
 }
 
@@ -832,28 +1230,27 @@ static bool execute_modifications_list(SimModification* head, binding_value_t ac
     bool any_state_changed = false;
     for (SimModification* mod = head; mod; mod = mod->next) {
         bool condition_met = true;
-        if (mod->condition_expr) {
-            binding_value_t cond_val = evaluate_expression(mod->condition_expr, action_value);
+        if (mod->condition_prog.code) {
+            binding_value_t cond_val = run_program(&mod->condition_prog, action_value);
             if (cond_val.type == BINDING_TYPE_BOOL) {
                 condition_met = cond_val.as.b_val;
             } else {
                 print_warning("UI-Sim: 'when' condition for state '%s' did not evaluate to a boolean.", mod->target_state_name);
                 condition_met = false;
             }
-            if(cond_val.type == BINDING_TYPE_STRING) free((void*)cond_val.as.s_val);
         }
 
         if (condition_met) {
-            if (mod->target_state_name && strcmp(mod->target_state_name, "time") == 0) {
+            if (mod->target_slot >= 0 ? mod->target_slot == g_sim.time_slot : strcmp(mod->target_state_name, "time") == 0) {
                 // The 'time' variable is special and managed by the simulator engine.
                 // We silently ignore user attempts to modify it to prevent confusion.
                 continue;
             }
-            SimStateVariable* target_state = find_state(mod->target_state_name);
-            if (!target_state) {
+            if (mod->target_slot < 0) {
                 print_warning("UI-Sim: Attempted to modify unknown state '%s'.", mod->target_state_name);
                 continue;
             }
+            SimStateVariable* target_state = &g_sim.states[mod->target_slot];
             if (target_state->is_derived) {
                 print_warning("UI-Sim: Cannot modify derived state '%s'.", mod->target_state_name);
                 continue;
@@ -861,26 +1258,24 @@ static bool execute_modifications_list(SimModification* head, binding_value_t ac
 
             switch (mod->type) {
                 case MOD_SET: {
-                    binding_value_t val = evaluate_expression(mod->value_expr, action_value);
+                    binding_value_t val = run_program(&mod->value_prog, action_value);
                     if (set_state_value(target_state, val)) any_state_changed = true;
                     break;
                 }
                 case MOD_INC: {
-                    binding_value_t val = evaluate_expression(mod->value_expr, action_value);
+                    binding_value_t val = run_program(&mod->value_prog, action_value);
                     if (target_state->value.type == BINDING_TYPE_FLOAT && val.type == BINDING_TYPE_FLOAT) {
                         binding_value_t new_val = {.type=BINDING_TYPE_FLOAT, .as.f_val=target_state->value.as.f_val + val.as.f_val};
                         if (set_state_value(target_state, new_val)) any_state_changed = true;
                     }
-                    if(val.type == BINDING_TYPE_STRING) free((void*)val.as.s_val);
                     break;
                 }
                 case MOD_DEC: {
-                     binding_value_t val = evaluate_expression(mod->value_expr, action_value);
+                    binding_value_t val = run_program(&mod->value_prog, action_value);
                     if (target_state->value.type == BINDING_TYPE_FLOAT && val.type == BINDING_TYPE_FLOAT) {
                         binding_value_t new_val = {.type=BINDING_TYPE_FLOAT, .as.f_val=target_state->value.as.f_val - val.as.f_val};
                         if (set_state_value(target_state, new_val)) any_state_changed = true;
                     }
-                    if(val.type == BINDING_TYPE_STRING) free((void*)val.as.s_val);
                     break;
                 }
                 case MOD_TOGGLE: {
@@ -893,28 +1288,19 @@ static bool execute_modifications_list(SimModification* head, binding_value_t ac
                     break;
                 }
                 case MOD_CYCLE: {
-                    if (!mod->value_expr || mod->value_expr->type != SIM_EXPR_FUNCTION || strcmp(mod->value_expr->as.function.func_name, "pair") != 0) {
+                    if (!mod->has_item_list) {
                         print_warning("UI-Sim: 'cycle' modifier for state '%s' has invalid value list.", target_state->name);
                         break;
                     }
 
-                    uint32_t count = 0;
-                    for(SimExpressionNode* n = mod->value_expr->as.function.args_head; n; n=n->next) count++;
-
+                    uint32_t count = mod->item_count;
                     if (count > 0) {
                         // Find the index of the current value in the cycle list
                         int current_idx = -1;
-                        SimExpressionNode* n = mod->value_expr->as.function.args_head;
-                        for(int i = 0; n; n = n->next, i++) {
-                            binding_value_t list_val = evaluate_expression(n->expr, action_value);
+                        for (uint32_t i = 0; i < count; i++) {
+                            binding_value_t list_val = run_program(&mod->item_progs[i], action_value);
                             if (values_are_equal(target_state->value, list_val)) {
-                                current_idx = i;
-                            }
-                            // We created a temporary value, free it if it was a string
-                            if (list_val.type == BINDING_TYPE_STRING) {
-                                free((void*)list_val.as.s_val);
-                            }
-                            if (current_idx != -1) {
+                                current_idx = (int)i;
                                 break;
                             }
                         }
@@ -926,32 +1312,21 @@ static bool execute_modifications_list(SimModification* head, binding_value_t ac
 
                         int next_idx = (current_idx + 1) % count;
 
-                        // Get the expression node for the next value
-                        SimExpressionNode* node_to_eval = mod->value_expr->as.function.args_head;
-                        for(int i = 0; i < next_idx; i++) {
-                            node_to_eval = node_to_eval->next;
-                        }
-
                         // Evaluate and set the new value
-                        binding_value_t val = evaluate_expression(node_to_eval->expr, action_value);
+                        binding_value_t val = run_program(&mod->item_progs[next_idx], action_value);
                         if (set_state_value(target_state, val)) any_state_changed = true;
                     }
                     break;
                 }
                  case MOD_RANGE: {
-                    if (!mod->value_expr) {
-                        print_warning("UI-Sim: 'range' modifier for state '%s' has no [min, max, step] values.", target_state->name);
-                        break;
-                    }
-                    if (mod->value_expr->type == SIM_EXPR_FUNCTION && strcmp(mod->value_expr->as.function.func_name, "pair") == 0 && mod->value_expr->as.function.args_head) {
-                        SimExpressionNode* n = mod->value_expr->as.function.args_head;
-                        if (!n || !n->next || !n->next->next) {
+                    if (mod->has_item_list && mod->item_count > 0) {
+                        if (mod->item_count < 3) {
                             print_warning("UI-Sim: 'range' modifier for state '%s' requires 3 arguments: [min, max, step].", target_state->name);
                             break;
                         }
-                        binding_value_t min_v = evaluate_expression(n->expr, action_value);
-                        binding_value_t max_v = evaluate_expression(n->next->expr, action_value);
-                        binding_value_t step_v = evaluate_expression(n->next->next->expr, action_value);
+                        binding_value_t min_v = run_program(&mod->item_progs[0], action_value);
+                        binding_value_t max_v = run_program(&mod->item_progs[1], action_value);
+                        binding_value_t step_v = run_program(&mod->item_progs[2], action_value);
 
                         if(target_state->value.type == BINDING_TYPE_FLOAT && min_v.type == BINDING_TYPE_FLOAT && max_v.type == BINDING_TYPE_FLOAT && step_v.type == BINDING_TYPE_FLOAT) {
                             float current = target_state->value.as.f_val;
@@ -962,9 +1337,6 @@ static bool execute_modifications_list(SimModification* head, binding_value_t ac
                         } else {
                              print_warning("UI-Sim: 'range' can only be used on float states with float arguments. State '%s' is not a float.", target_state->name);
                         }
-                        if(min_v.type == BINDING_TYPE_STRING) free((void*)min_v.as.s_val);
-                        if(max_v.type == BINDING_TYPE_STRING) free((void*)max_v.as.s_val);
-                        if(step_v.type == BINDING_TYPE_STRING) free((void*)step_v.as.s_val);
                     }
                     break;
                 }
@@ -974,102 +1346,135 @@ static bool execute_modifications_list(SimModification* head, binding_value_t ac
     return any_state_changed;
 }
 
-static binding_value_t evaluate_expression(SimExpression* expr, binding_value_t action_value) {
-    if (!expr) return (binding_value_t){.type = BINDING_TYPE_NULL};
+#define IS_FLOAT(v) ((v).type == BINDING_TYPE_FLOAT)
+#define IS_BOOL(v) ((v).type == BINDING_TYPE_BOOL)
+#define FLOAT_EPSILON 1e-6f
 
-    switch(expr->type) {
-        case SIM_EXPR_LITERAL:
-            if (expr->as.literal.type == BINDING_TYPE_STRING) {
-                return (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = strdup(expr->as.literal.as.s_val)};
-            }
-            return expr->as.literal;
-        case SIM_EXPR_ACTION_VALUE:
-            if(action_value.type == expr->as.action_value_type) {
-                if(action_value.type == BINDING_TYPE_STRING && action_value.as.s_val) {
-                    return (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = strdup(action_value.as.s_val)};
-                }
-                return action_value;
-            }
-            print_hint("UI-Sim Hint: Action payload 'value' was requested as the wrong type.");
-            return (binding_value_t){.type = BINDING_TYPE_NULL};
-        case SIM_EXPR_STATE_REF: {
-            SimStateVariable* state = find_state(expr->as.state_ref.state_name);
-            if (state) {
-                if(expr->as.state_ref.is_negated && state->value.type == BINDING_TYPE_BOOL) {
-                    return (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=!state->value.as.b_val};
-                }
-                if (state->value.type == BINDING_TYPE_STRING) {
-                    return (binding_value_t){.type = BINDING_TYPE_STRING, .as.s_val = strdup(state->value.as.s_val)};
-                }
-                return state->value;
-            }
-            print_warning("UI-Sim: Expression referenced unknown state '%s'.", expr->as.state_ref.state_name);
-            return (binding_value_t){.type = BINDING_TYPE_NULL};
-        }
-        case SIM_EXPR_FUNCTION: {
-            SimExpression* arg_exprs[UI_SIM_MAX_FUNC_ARGS];
-            binding_value_t arg_values[UI_SIM_MAX_FUNC_ARGS];
-            int argc = 0;
-            for(SimExpressionNode* n = expr->as.function.args_head; n && argc < UI_SIM_MAX_FUNC_ARGS; n=n->next, argc++) {
-                arg_exprs[argc] = n->expr;
-                arg_values[argc] = evaluate_expression(n->expr, action_value);
-            }
-
-            #define IS_FLOAT(v) ((v).type == BINDING_TYPE_FLOAT)
-            #define IS_BOOL(v) ((v).type == BINDING_TYPE_BOOL)
-            #define FLOAT_EPSILON 1e-6f
-
-            binding_value_t ret = {.type = BINDING_TYPE_NULL};
-            const char* name = expr->as.function.func_name;
-
-            if (strcmp(name, "add") == 0 && argc >= 2) {
+static binding_value_t call_function(SimFunction fn, const binding_value_t* args, int argc) {
+    binding_value_t ret = {.type = BINDING_TYPE_NULL};
+    switch (fn) {
+        case SIM_FN_ADD:
+            if (argc >= 2) {
                 float sum = 0.0f;
-                for (int i=0; i < argc; i++) { if (IS_FLOAT(arg_values[i])) sum += arg_values[i].as.f_val; }
+                for (int i = 0; i < argc; i++) { if (IS_FLOAT(args[i])) sum += args[i].as.f_val; }
                 ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=sum};
-            } else if (strcmp(name, "mul") == 0 && argc >= 2) {
+            }
+            break;
+        case SIM_FN_MUL:
+            if (argc >= 2) {
                 float product = 1.0f;
-                for (int i=0; i < argc; i++) { if (IS_FLOAT(arg_values[i])) product *= arg_values[i].as.f_val; }
+                for (int i = 0; i < argc; i++) { if (IS_FLOAT(args[i])) product *= args[i].as.f_val; }
                 ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=product};
             }
-            else if(strcmp(name, "sub") == 0 && argc==2 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=arg_values[0].as.f_val - arg_values[1].as.f_val};
-            else if(strcmp(name, "div") == 0 && argc==2 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=arg_values[1].as.f_val==0.0f? 0.0f : arg_values[0].as.f_val / arg_values[1].as.f_val};
-            else if(strcmp(name, "sin") == 0 && argc==1 && IS_FLOAT(arg_values[0])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=sinf(arg_values[0].as.f_val)};
-            else if(strcmp(name, "cos") == 0 && argc==1 && IS_FLOAT(arg_values[0])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=cosf(arg_values[0].as.f_val)};
-            else if(strcmp(name, "clamp") == 0 && argc==3 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1]) && IS_FLOAT(arg_values[2])) { float v=arg_values[0].as.f_val; float min=arg_values[1].as.f_val; float max=arg_values[2].as.f_val; ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=fmaxf(min, fminf(v, max))};}
-            else if(strcmp(name, "==") == 0 && argc==2) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=values_are_equal(arg_values[0], arg_values[1])};
-            else if(strcmp(name, "!=") == 0 && argc==2) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=!values_are_equal(arg_values[0], arg_values[1])};
-            else if(strcmp(name, ">") == 0 && argc==2 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(arg_values[0].as.f_val - arg_values[1].as.f_val) > FLOAT_EPSILON};
-            else if(strcmp(name, "<") == 0 && argc==2 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(arg_values[1].as.f_val - arg_values[0].as.f_val) > FLOAT_EPSILON};
-            else if(strcmp(name, ">=") == 0 && argc==2 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(arg_values[0].as.f_val - arg_values[1].as.f_val) > -FLOAT_EPSILON};
-            else if(strcmp(name, "<=") == 0 && argc==2 && IS_FLOAT(arg_values[0]) && IS_FLOAT(arg_values[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(arg_values[1].as.f_val - arg_values[0].as.f_val) > -FLOAT_EPSILON};
-            else if(strcmp(name, "and") == 0 && argc > 0) { bool r = true; for(int i=0; i<argc; i++) { if(!IS_BOOL(arg_values[i]) || !arg_values[i].as.b_val) { r=false; break; } } ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=r}; }
-            else if(strcmp(name, "or") == 0 && argc > 0) { bool r = false; for(int i=0; i<argc; i++) { if(IS_BOOL(arg_values[i]) && arg_values[i].as.b_val) { r=true; break; } } ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=r}; }
-            else if(strcmp(name, "not") == 0 && argc == 1 && IS_BOOL(arg_values[0])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=!arg_values[0].as.b_val};
-            else if(strcmp(name, "case") == 0 && argc > 0) {
-                 for(int i=0; i<argc; i++) {
-                     SimExpression* pair_expr = arg_exprs[i];
-                     if(pair_expr->type == SIM_EXPR_FUNCTION && strcmp(pair_expr->as.function.func_name, "pair") == 0 && pair_expr->as.function.args_head) {
-                        SimExpression* cond_expr = pair_expr->as.function.args_head->expr;
-                        binding_value_t cond_val = evaluate_expression(cond_expr, action_value);
-
-                        if (IS_BOOL(cond_val) && cond_val.as.b_val) {
-                             SimExpression* val_expr = pair_expr->as.function.args_head->next->expr;
-                             ret = evaluate_expression(val_expr, action_value);
-                             if (cond_val.type == BINDING_TYPE_STRING) free((void*)cond_val.as.s_val);
-                             break;
-                        }
-                        if (cond_val.type == BINDING_TYPE_STRING) free((void*)cond_val.as.s_val);
-                     }
-                 }
+            break;
+        case SIM_FN_SUB:
+            if (argc == 2 && IS_FLOAT(args[0]) && IS_FLOAT(args[1])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=args[0].as.f_val - args[1].as.f_val};
+            break;
+        case SIM_FN_DIV:
+            if (argc == 2 && IS_FLOAT(args[0]) && IS_FLOAT(args[1])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=args[1].as.f_val==0.0f? 0.0f : args[0].as.f_val / args[1].as.f_val};
+            break;
+        case SIM_FN_SIN:
+            if (argc == 1 && IS_FLOAT(args[0])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=sinf(args[0].as.f_val)};
+            break;
+        case SIM_FN_COS:
+            if (argc == 1 && IS_FLOAT(args[0])) ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=cosf(args[0].as.f_val)};
+            break;
+        case SIM_FN_CLAMP:
+            if (argc == 3 && IS_FLOAT(args[0]) && IS_FLOAT(args[1]) && IS_FLOAT(args[2])) {
+                float v = args[0].as.f_val, min = args[1].as.f_val, max = args[2].as.f_val;
+                ret = (binding_value_t){.type=BINDING_TYPE_FLOAT, .as.f_val=fmaxf(min, fminf(v, max))};
             }
+            break;
+        case SIM_FN_EQ:
+            if (argc == 2) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=values_are_equal(args[0], args[1])};
+            break;
+        case SIM_FN_NE:
+            if (argc == 2) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=!values_are_equal(args[0], args[1])};
+            break;
+        case SIM_FN_GT:
+            if (argc == 2 && IS_FLOAT(args[0]) && IS_FLOAT(args[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(args[0].as.f_val - args[1].as.f_val) > FLOAT_EPSILON};
+            break;
+        case SIM_FN_LT:
+            if (argc == 2 && IS_FLOAT(args[0]) && IS_FLOAT(args[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(args[1].as.f_val - args[0].as.f_val) > FLOAT_EPSILON};
+            break;
+        case SIM_FN_GE:
+            if (argc == 2 && IS_FLOAT(args[0]) && IS_FLOAT(args[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(args[0].as.f_val - args[1].as.f_val) > -FLOAT_EPSILON};
+            break;
+        case SIM_FN_LE:
+            if (argc == 2 && IS_FLOAT(args[0]) && IS_FLOAT(args[1])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=(args[1].as.f_val - args[0].as.f_val) > -FLOAT_EPSILON};
+            break;
+        case SIM_FN_AND:
+            if (argc > 0) {
+                bool r = true;
+                for (int i = 0; i < argc; i++) { if (!IS_BOOL(args[i]) || !args[i].as.b_val) { r = false; break; } }
+                ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=r};
+            }
+            break;
+        case SIM_FN_OR:
+            if (argc > 0) {
+                bool r = false;
+                for (int i = 0; i < argc; i++) { if (IS_BOOL(args[i]) && args[i].as.b_val) { r = true; break; } }
+                ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=r};
+            }
+            break;
+        case SIM_FN_NOT:
+            if (argc == 1 && IS_BOOL(args[0])) ret = (binding_value_t){.type=BINDING_TYPE_BOOL, .as.b_val=!args[0].as.b_val};
+            break;
+        default:
+            break;
+    }
+    return ret;
+}
 
-            for(int i=0; i < argc; i++) {
-                 if (arg_values[i].type == BINDING_TYPE_STRING) free((void*)arg_values[i].as.s_val);
+// Runs a compiled expression. No function creates a string, so every value,
+// including the result, is borrowed from the constants, the states or the action
+// payload. It stays valid until a state is set; set_state_value() copies it.
+static binding_value_t run_program(const SimProgram* prog, binding_value_t action_value) {
+    binding_value_t* stack = g_sim.vm_stack;
+    uint32_t sp = 0;
+    uint32_t pc = 0;
+    while (pc < prog->code_len) {
+        const SimInstruction* ins = &prog->code[pc++];
+        switch (ins->op) {
+            case SIM_OP_NULL:
+                stack[sp++] = (binding_value_t){.type = BINDING_TYPE_NULL};
+                break;
+            case SIM_OP_CONST:
+                stack[sp++] = prog->consts[ins->arg];
+                break;
+            case SIM_OP_STATE:
+                stack[sp++] = g_sim.states[ins->arg].value;
+                break;
+            case SIM_OP_STATE_NOT: {
+                binding_value_t v = g_sim.states[ins->arg].value;
+                if (v.type == BINDING_TYPE_BOOL) v.as.b_val = !v.as.b_val;
+                stack[sp++] = v;
+                break;
+            }
+            case SIM_OP_ACTION_VALUE:
+                if (action_value.type == (binding_value_type_t)ins->arg) {
+                    stack[sp++] = action_value;
+                } else {
+                    print_hint("UI-Sim Hint: Action payload 'value' was requested as the wrong type.");
+                    stack[sp++] = (binding_value_t){.type = BINDING_TYPE_NULL};
+                }
+                break;
+            case SIM_OP_CALL:
+                sp -= ins->argc;
+                stack[sp] = call_function((SimFunction)ins->arg, &stack[sp], ins->argc);
+                sp++;
+                break;
+            case SIM_OP_JUMP:
+                pc = ins->arg;
+                break;
+            case SIM_OP_JUMP_UNLESS: {
+                binding_value_t cond = stack[--sp];
+                if (!IS_BOOL(cond) || !cond.as.b_val) pc = ins->arg;
+                break;
             }
-            return ret;
         }
     }
-    return (binding_value_t){.type = BINDING_TYPE_NULL};
+    return sp > 0 ? stack[sp - 1] : (binding_value_t){.type = BINDING_TYPE_NULL};
 }
 
 // --- Utility Functions ---
@@ -1080,6 +1485,9 @@ static bool values_are_equal(binding_value_t v1, binding_value_t v2) {
         case BINDING_TYPE_NULL: return true;
         case BINDING_TYPE_BOOL: return v1.as.b_val == v2.as.b_val;
         case BINDING_TYPE_FLOAT: return fabsf(v1.as.f_val - v2.as.f_val) < FLOAT_EPSILON;
+        case BINDING_TYPE_INT: return v1.as.i_val == v2.as.i_val;
+        case BINDING_TYPE_INT64: return v1.as.i64_val == v2.as.i64_val;
+        case BINDING_TYPE_DOUBLE: return fabs(v1.as.d_val - v2.as.d_val) < FLOAT_EPSILON;
         case BINDING_TYPE_STRING:
             if (v1.as.s_val == NULL || v2.as.s_val == NULL) return v1.as.s_val == v2.as.s_val;
             return strcmp(v1.as.s_val, v2.as.s_val) == 0;
@@ -1087,11 +1495,31 @@ static bool values_are_equal(binding_value_t v1, binding_value_t v2) {
     return false;
 }
 
+// Stores a value in a state. A string is copied into the state's own buffer, which
+// only grows, so repeated updates of a string state do not allocate.
+static void store_state_value(SimStateVariable* state, binding_value_t value) {
+    if (value.type == BINDING_TYPE_STRING && value.as.s_val) {
+        size_t len = strlen(value.as.s_val) + 1;
+        if (len > state->string_cap) {
+            char* new_buf = realloc(state->string_buf, len);
+            if (!new_buf) render_abort("Failed to allocate UI-Sim state string buffer");
+            state->string_buf = new_buf;
+            state->string_cap = len;
+        }
+        memmove(state->string_buf, value.as.s_val, len);
+        value.as.s_val = state->string_buf;
+    }
+    state->value = value;
+}
+
 static void trace_print_value(binding_value_t v) {
     switch(v.type) {
         case BINDING_TYPE_NULL: fprintf(stderr, "null"); break;
         case BINDING_TYPE_FLOAT: fprintf(stderr, "%.3f", v.as.f_val); break;
         case BINDING_TYPE_BOOL: fprintf(stderr, "%s", v.as.b_val ? "true" : "false"); break;
         case BINDING_TYPE_STRING: fprintf(stderr, "\"%s\"", v.as.s_val ? v.as.s_val : ""); break;
+        case BINDING_TYPE_INT: fprintf(stderr, "%d", (int)v.as.i_val); break;
+        case BINDING_TYPE_INT64: fprintf(stderr, "%lld", (long long)v.as.i64_val); break;
+        case BINDING_TYPE_DOUBLE: fprintf(stderr, "%.3f", v.as.d_val); break;
     }
 }
@@ -8,7 +8,6 @@
 
 #define UI_SIM_MAX_STATES 128
 #define UI_SIM_MAX_ACTIONS 256
-#define UI_SIM_MAX_SCHEDULED_ACTIONS 64
 #define UI_SIM_MAX_FUNC_ARGS 64
 
 // --- Global Configuration ---
@@ -44,6 +43,32 @@ typedef struct SimExpressionNode {
     struct SimExpressionNode* next;
 } SimExpressionNode;
 
+// Instructions of a compiled expression. ui_sim_process_node() compiles every
+// expression once all states are known, and the runtime only runs the programs.
+typedef enum {
+    SIM_OP_NULL,         // Pushes null
+    SIM_OP_CONST,        // Pushes constant `arg`
+    SIM_OP_STATE,        // Pushes the value of the state in slot `arg`
+    SIM_OP_STATE_NOT,    // Same, negated if it is a bool ("!name")
+    SIM_OP_ACTION_VALUE, // Pushes the action payload if its type is `arg`, else null
+    SIM_OP_CALL,         // Pops `argc` values, pushes the result of function `arg`
+    SIM_OP_JUMP,         // Continues at instruction `arg`
+    SIM_OP_JUMP_UNLESS,  // Pops a value, continues at instruction `arg` unless it is true
+} SimOpcode;
+
+typedef struct {
+    uint8_t op;   // A SimOpcode
+    uint8_t argc;
+    uint16_t arg;
+} SimInstruction;
+
+typedef struct {
+    SimInstruction* code; // NULL if there is no expression
+    uint32_t code_len;
+    binding_value_t* consts; // Owns the strings of string constants
+    uint32_t const_count;
+} SimProgram;
+
 typedef enum {
     MOD_SET,
     MOD_INC,
@@ -56,17 +81,29 @@ typedef enum {
 typedef struct SimModification {
     SimModificationType type;
     char* target_state_name;
-    SimExpression* value_expr;
+    SimExpression* value_expr;     // Parsed form, freed once compiled
     SimExpression* condition_expr;
+    int32_t target_slot;           // Index into the states, -1 if unknown
+    SimProgram value_prog;
+    SimProgram condition_prog;
+    bool has_item_list;            // The value is a list, e.g. for cycle and range
+    SimProgram* item_progs;        // One program per list item
+    uint32_t item_count;
     struct SimModification* next;
 } SimModification;
 
 typedef struct {
     char* name;
     binding_value_t value;
+    char* string_buf;            // Holds a string value; reused across updates
+    size_t string_cap;
     bool is_dirty;
     bool is_derived;
-    SimExpression* derived_expr;
+    SimExpression* derived_expr; // Parsed form, freed once compiled
+    SimProgram derived_prog;
+    bool needs_eval;             // A state this one reads changed since it was last evaluated
+    uint32_t* dependents;        // Slots of the derived states that read this state
+    uint32_t dependent_count;
 } SimStateVariable;
 
 typedef struct {
@@ -75,9 +112,13 @@ typedef struct {
 } SimAction;
 
 typedef struct {
-    uint32_t tick;
+    uint64_t tick;      // First tick the action runs on (1-based)
+    uint64_t every;     // Period in ticks of a repeating action, 0 if it runs once
+    uint32_t times;     // Runs of a repeating action, 0 for no limit
     char* name;
     binding_value_t value;
+    uint64_t next_tick; // Tick of the next run, while the action is in the schedule heap
+    uint32_t runs;
 } SimScheduledAction;
 
 